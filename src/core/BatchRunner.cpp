@@ -0,0 +1,63 @@
+#include "BatchRunner.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+BatchResult BatchRunner::Run()
+{
+    if (p_Simulation == nullptr)
+    {
+        throw std::invalid_argument("BatchRunner requires a simulation");
+    }
+
+    p_Simulation->Reset();
+    return Resume();
+}
+
+BatchResult BatchRunner::Resume()
+{
+    if (p_Simulation == nullptr)
+    {
+        throw std::invalid_argument("BatchRunner requires a simulation");
+    }
+
+    // A batch run must terminate, so an end time is required
+    if (p_Simulation->getSimulationEndTime() <= 0.0)
+    {
+        throw std::invalid_argument("BatchRunner requires a simulation end time");
+    }
+
+    p_Simulation->Initialize();
+
+    BatchResult result;
+    if (p_Simulation->getSimulationTime() >= p_Simulation->getSimulationEndTime())
+    {
+        return result;
+    }
+
+    const uint64_t startSampleCount = p_Simulation->getSampleCount();
+    const uint64_t startSkippedSampleCount = p_Simulation->getSkippedSampleCount();
+    const double startTime = p_Simulation->getSimulationTime();
+    p_Simulation->Start();
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    while (p_Simulation->isRunning())
+    {
+        p_Simulation->Update();
+        result.updateCount++;
+    }
+
+    auto wallEnd = std::chrono::steady_clock::now();
+
+    result.sampleCount = p_Simulation->getSampleCount() - startSampleCount;
+    result.skippedSampleCount = p_Simulation->getSkippedSampleCount() - startSkippedSampleCount;
+    result.simulatedTime = p_Simulation->getSimulationTime() - startTime;
+    result.wallTime = std::chrono::duration<double>(wallEnd - wallStart).count();
+    if (result.wallTime > 0.0)
+    {
+        result.samplesPerSecond = static_cast<double>(result.sampleCount) / result.wallTime;
+    }
+
+    return result;
+}
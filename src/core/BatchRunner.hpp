@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Simulation.hpp"
+
+#include <cstdint>
+
+struct BatchResult
+{
+    uint64_t updateCount = 0;      // Number of Simulation::Update() calls performed
+    uint64_t sampleCount = 0;      // Number of simulated samples (time steps)
+    uint64_t skippedSampleCount = 0; // Samples of sampleCount jumped over in discrete-event mode
+    double simulatedTime = 0.0;    // sec
+    double wallTime = 0.0;         // sec
+    double samplesPerSecond = 0.0; // Simulated samples per wall-clock second
+};
+
+// Drives a Simulation as fast as possible until its end time without any rendering
+class BatchRunner
+{
+public:
+    BatchRunner(Simulation *simulation) : p_Simulation(simulation) {}
+    virtual ~BatchRunner() = default;
+
+    // Resets the simulation and runs it from its start time
+    virtual BatchResult Run();
+
+    // Runs from the simulation's current state, e.g. after restoring a checkpoint
+    virtual BatchResult Resume();
+
+protected:
+    Simulation *p_Simulation = nullptr;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+// Helpers for the Simulation's integer tick clock.
+// Phase is kept in fixed point where one full cycle is 2^64, so it wraps exactly and the phase of any
+// sample can be computed directly from its tick without accumulating rounding errors.
+namespace Clock
+{
+    // Nearest tick to a time
+    inline int64_t TimeToTicks(double time, double tickPeriod)
+    {
+        return static_cast<int64_t>(std::llround(time / tickPeriod));
+    }
+
+    // Fixed point phase advanced by a frequency over one period, modulo a full cycle
+    inline uint64_t PhaseIncrement(double frequency, double period)
+    {
+        // The rounding error of the product is recovered exactly with an fma, the whole cycles would otherwise
+        // eat into the precision of the fraction
+        const double cycles = frequency * period;
+        const double error = std::fma(frequency, period, -cycles);
+        const double fraction = cycles - std::floor(cycles);
+
+        // fraction is in [0, 1), scale it to [0, 2^64) without overflowing on the upper edge
+        const double scaled = std::ldexp(fraction, 64);
+        uint64_t phase = scaled >= 18446744073709551615.0 ? 0 : static_cast<uint64_t>(scaled);
+        if (std::fabs(error) < 1.0)
+        {
+            phase += static_cast<uint64_t>(std::llround(std::ldexp(error, 64)));
+        }
+        return phase;
+    }
+
+    // Fixed point phase of a frequency at a tick. The tick is split in two halves so the quantization of the
+    // increments is only multiplied by 32 bit counts, keeping the error around 1e-10 cycles even after days of ticks.
+    // Ticks before zero are the negated phase of their magnitude, so the same bound holds on both sides.
+    inline uint64_t PhaseAtTick(double frequency, double tickPeriod, int64_t tick)
+    {
+        // The magnitude is taken in unsigned arithmetic so INT64_MIN doesn't overflow
+        const uint64_t ticks = tick < 0 ? 0 - static_cast<uint64_t>(tick) : static_cast<uint64_t>(tick);
+        const uint64_t high = ticks >> 32;
+        const uint64_t low = ticks & 0xFFFFFFFFull;
+        const uint64_t phase = PhaseIncrement(frequency, std::ldexp(tickPeriod, 32)) * high + PhaseIncrement(frequency, tickPeriod) * low;
+        return tick < 0 ? 0 - phase : phase;
+    }
+
+    // Fixed point phase to radians in [-PI, PI)
+    inline double PhaseToRadians(uint64_t phase)
+    {
+        return std::ldexp(static_cast<double>(static_cast<int64_t>(phase)), -64) * 2 * Constants::PI;
+    }
+}
@@ -0,0 +1,173 @@
+#include "EnsembleRunner.hpp"
+
+#include "BatchRunner.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+void MetricSummary::Add(double value)
+{
+    // Welford's update
+    count++;
+    const double delta = value - mean;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * (value - mean);
+    min = std::min(min, value);
+    max = std::max(max, value);
+}
+
+uint64_t EnsembleRunner::DeriveSeed(uint64_t baseSeed, uint64_t run)
+{
+    // SplitMix64 finalizer
+    uint64_t z = baseSeed + (run + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+namespace
+{
+    struct FinishedRun
+    {
+        uint64_t seed = 0;
+        bool succeeded = false;
+        std::vector<double> metrics;
+    };
+
+    struct EnsembleContext
+    {
+        const SimulationParameters *simParams;
+        const ScenarioFactory *factory;
+        const MetricExtractor *metrics;
+        const RunCallback *callback;
+        const EnsembleParameters *params;
+        EnsembleResult *result;
+
+        // Finished runs wait here until every earlier run has been folded into the result
+        std::mutex mutex;
+        std::map<int, FinishedRun> finished;
+        int nextRun = 0;
+        std::exception_ptr error;
+    };
+
+    void FoldFinishedRuns(EnsembleContext &context)
+    {
+        auto it = context.finished.begin();
+        while (it != context.finished.end() && it->first == context.nextRun)
+        {
+            const FinishedRun &run = it->second;
+            if (run.succeeded)
+            {
+                for (size_t m = 0; m < context.result->metrics.size() && m < run.metrics.size(); m++)
+                {
+                    context.result->metrics[m].Add(run.metrics[m]);
+                }
+                if (*context.callback)
+                {
+                    (*context.callback)(it->first, run.seed, run.metrics);
+                }
+                context.result->runCount++;
+            }
+
+            context.nextRun++;
+            it = context.finished.erase(it);
+        }
+    }
+
+    void RunOne(void *contextPointer, size_t index)
+    {
+        EnsembleContext &context = *static_cast<EnsembleContext *>(contextPointer);
+        const int run = static_cast<int>(index);
+
+        try
+        {
+            // Every run is single threaded, the parallelism is across runs
+            SimulationParameters simParams = *context.simParams;
+            simParams.seed = EnsembleRunner::DeriveSeed(context.params->baseSeed, index);
+            simParams.threadCount = 1;
+
+            std::unique_ptr<Scenario> scenario = (*context.factory)(simParams);
+            BatchRunner batch(&scenario->getSimulation());
+            BatchResult batchResult = batch.Run();
+            std::vector<double> values = (*context.metrics)(*scenario);
+
+            std::lock_guard<std::mutex> lock(context.mutex);
+            context.result->sampleCount += batchResult.sampleCount;
+            context.finished[run] = {simParams.seed, true, std::move(values)};
+            FoldFinishedRuns(context);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(context.mutex);
+            if (!context.error)
+            {
+                context.error = std::current_exception();
+            }
+
+            // Keep later runs from waiting on this one forever
+            context.finished[run] = {};
+            FoldFinishedRuns(context);
+        }
+    }
+}
+
+EnsembleResult EnsembleRunner::Run(const EnsembleParameters &params, const RunCallback &callback)
+{
+    if (!m_Factory || !m_Metrics)
+    {
+        throw std::invalid_argument("EnsembleRunner requires a scenario factory and a metric extractor");
+    }
+    if (params.runCount <= 0)
+    {
+        throw std::invalid_argument("EnsembleRunner requires at least one run");
+    }
+
+    EnsembleResult result;
+    result.metrics.resize(m_MetricNames.size());
+
+    EnsembleContext context{&m_SimParams, &m_Factory, &m_Metrics, &callback, &params, &result};
+
+    int threadCount = params.threadCount;
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+    threadCount = std::min(threadCount, params.runCount);
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    if (threadCount <= 1)
+    {
+        for (int run = 0; run < params.runCount; run++)
+        {
+            RunOne(&context, static_cast<size_t>(run));
+        }
+    }
+    else
+    {
+        // The calling thread takes part in the work, so the pool needs one thread less
+        ThreadPool pool(threadCount - 1);
+        pool.ParallelFor(static_cast<size_t>(params.runCount), &RunOne, &context);
+    }
+
+    auto wallEnd = std::chrono::steady_clock::now();
+
+    if (context.error)
+    {
+        std::rethrow_exception(context.error);
+    }
+
+    result.wallTime = std::chrono::duration<double>(wallEnd - wallStart).count();
+    if (result.wallTime > 0.0)
+    {
+        result.samplesPerSecond = static_cast<double>(result.sampleCount) / result.wallTime;
+    }
+
+    return result;
+}
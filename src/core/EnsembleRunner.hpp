@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Scenario.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct EnsembleParameters
+{
+    int runCount = 1;
+    uint64_t baseSeed = 0; // Run i uses a seed derived from (baseSeed, i)
+    int threadCount = 0;   // Runs executed in parallel, 0 uses every hardware thread
+};
+
+// Running statistics of one metric across runs
+struct MetricSummary
+{
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0; // Sum of squared deviations from the mean
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void Add(double value);
+    double Variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+};
+
+struct EnsembleResult
+{
+    int runCount = 0;
+    std::vector<MetricSummary> metrics; // One per metric name
+    uint64_t sampleCount = 0;           // Samples simulated across all runs
+    double wallTime = 0.0;              // sec
+    double samplesPerSecond = 0.0;      // Aggregate simulated samples per wall-clock second
+};
+
+// Builds a scenario for a run from its parameters, the seed is already set in params
+using ScenarioFactory = std::function<std::unique_ptr<Scenario>(const SimulationParameters &params)>;
+
+// Extracts the metrics of a finished run, one value per metric name
+using MetricExtractor = std::function<std::vector<double>(Scenario &scenario)>;
+
+// Called once per finished run, in run order
+using RunCallback = std::function<void(int run, uint64_t seed, const std::vector<double> &metrics)>;
+
+// Runs independent instances of a scenario with different seeds in parallel and reduces their metrics.
+// Runs are folded into the result in run order, so the result doesn't depend on the thread count.
+class EnsembleRunner
+{
+public:
+    EnsembleRunner(const SimulationParameters &simParams, ScenarioFactory factory, MetricExtractor metrics, std::vector<std::string> metricNames)
+        : m_SimParams(simParams), m_Factory(std::move(factory)), m_Metrics(std::move(metrics)), m_MetricNames(std::move(metricNames)) {}
+    virtual ~EnsembleRunner() = default;
+
+    virtual EnsembleResult Run(const EnsembleParameters &params, const RunCallback &callback = nullptr);
+
+    const std::vector<std::string> &getMetricNames() const { return m_MetricNames; }
+
+    // Seed of a run, independent streams for neighbouring runs
+    static uint64_t DeriveSeed(uint64_t baseSeed, uint64_t run);
+
+protected:
+    SimulationParameters m_SimParams;
+    ScenarioFactory m_Factory;
+    MetricExtractor m_Metrics;
+    std::vector<std::string> m_MetricNames;
+};
@@ -0,0 +1,342 @@
+#include "ParameterSweep.hpp"
+
+#include "BatchRunner.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <stdio.h>
+#include <thread>
+
+bool SweepPoint::Has(const std::string &name) const
+{
+    for (const SweepDimension &dimension : *p_Dimensions)
+    {
+        if (dimension.name == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+double SweepPoint::Get(const std::string &name, double fallback) const
+{
+    for (size_t i = 0; i < p_Dimensions->size(); i++)
+    {
+        if ((*p_Dimensions)[i].name == name)
+        {
+            return (*p_Values)[i];
+        }
+    }
+    return fallback;
+}
+
+bool ParameterSweep::SetSimulationParameter(SimulationParameters &params, const std::string &name, double value)
+{
+    if (name == "simTimeStep")
+    {
+        params.simTimeStep = value;
+    }
+    else if (name == "simStartTime")
+    {
+        params.simStartTime = value;
+    }
+    else if (name == "simEndTime")
+    {
+        params.simEndTime = value;
+    }
+    else if (name == "updateCountPerFrame")
+    {
+        params.updateCountPerFrame = static_cast<int>(std::lround(value));
+    }
+    else if (name == "publishInterval")
+    {
+        params.publishInterval = value;
+    }
+    else if (name == "blockSize")
+    {
+        params.blockSize = static_cast<int>(std::lround(value));
+    }
+    else if (name == "tickPeriod")
+    {
+        params.tickPeriod = value;
+    }
+    else if (name == "seed")
+    {
+        params.seed = static_cast<uint64_t>(std::llround(value));
+    }
+    else if (name == "eventDriven")
+    {
+        params.eventDriven = value != 0.0;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::vector<double>> ParameterSweep::GeneratePoints(const SweepParameters &params)
+{
+    const size_t dimensionCount = params.dimensions.size();
+    std::vector<std::vector<double>> points;
+
+    if (params.mode == SweepMode::Grid)
+    {
+        size_t pointCount = 1;
+        for (const SweepDimension &dimension : params.dimensions)
+        {
+            if (dimension.count <= 0)
+            {
+                throw std::invalid_argument("ParameterSweep: dimension '" + dimension.name + "' has no values");
+            }
+            pointCount *= static_cast<size_t>(dimension.count);
+        }
+
+        // The first dimension varies slowest
+        points.resize(pointCount, std::vector<double>(dimensionCount));
+        for (size_t p = 0; p < pointCount; p++)
+        {
+            size_t remainder = p;
+            for (size_t d = dimensionCount; d-- > 0;)
+            {
+                const SweepDimension &dimension = params.dimensions[d];
+                const size_t step = remainder % static_cast<size_t>(dimension.count);
+                remainder /= static_cast<size_t>(dimension.count);
+
+                const double fraction = dimension.count > 1 ? static_cast<double>(step) / (dimension.count - 1) : 0.0;
+                points[p][d] = dimension.min + fraction * (dimension.max - dimension.min);
+            }
+        }
+    }
+    else
+    {
+        if (params.sampleCount <= 0)
+        {
+            throw std::invalid_argument("ParameterSweep: a Latin hypercube needs at least one sample");
+        }
+
+        const size_t pointCount = static_cast<size_t>(params.sampleCount);
+        points.resize(pointCount, std::vector<double>(dimensionCount));
+
+        // SplitMix64 stream, identical on every platform unlike the <random> distributions
+        uint64_t counter = 0;
+        auto next = [&]() { return EnsembleRunner::DeriveSeed(params.seed, counter++); };
+        auto nextUniform = [&]() { return static_cast<double>(next() >> 11) * 0x1.0p-53; };
+
+        std::vector<size_t> strata(pointCount);
+        for (size_t d = 0; d < dimensionCount; d++)
+        {
+            const SweepDimension &dimension = params.dimensions[d];
+
+            // Fisher-Yates shuffle of the strata
+            for (size_t i = 0; i < pointCount; i++)
+            {
+                strata[i] = i;
+            }
+            for (size_t i = pointCount - 1; i > 0; i--)
+            {
+                std::swap(strata[i], strata[next() % (i + 1)]);
+            }
+
+            for (size_t p = 0; p < pointCount; p++)
+            {
+                const double fraction = (static_cast<double>(strata[p]) + nextUniform()) / static_cast<double>(pointCount);
+                points[p][d] = dimension.min + fraction * (dimension.max - dimension.min);
+            }
+        }
+    }
+
+    return points;
+}
+
+namespace
+{
+    struct FinishedPoint
+    {
+        bool succeeded = false;
+        std::vector<double> metrics;
+    };
+
+    struct SweepContext
+    {
+        const SimulationParameters *simParams;
+        const SweepScenarioFactory *factory;
+        const MetricExtractor *metrics;
+        const SweepRowCallback *callback;
+        const SweepParameters *params;
+        const std::vector<std::vector<double>> *points;
+        SweepResult *result;
+        FILE *output;
+
+        // Finished points wait here until every earlier point has been written
+        std::mutex mutex;
+        std::map<int, FinishedPoint> finished;
+        int nextPoint = 0;
+        std::exception_ptr error;
+    };
+
+    void WriteHeader(FILE *output, const SweepParameters &params, const std::vector<std::string> &metricNames)
+    {
+        fprintf(output, "point");
+        for (const SweepDimension &dimension : params.dimensions)
+        {
+            fprintf(output, ",%s", dimension.name.c_str());
+        }
+        for (const std::string &name : metricNames)
+        {
+            fprintf(output, ",%s", name.c_str());
+        }
+        fprintf(output, "\n");
+    }
+
+    void WriteFinishedPoints(SweepContext &context)
+    {
+        auto it = context.finished.begin();
+        while (it != context.finished.end() && it->first == context.nextPoint)
+        {
+            const FinishedPoint &finished = it->second;
+            if (finished.succeeded)
+            {
+                const std::vector<double> &values = (*context.points)[it->first];
+                SweepPoint point(it->first, context.params->dimensions, values);
+
+                if (context.output != nullptr)
+                {
+                    fprintf(context.output, "%d", it->first);
+                    for (double value : values)
+                    {
+                        fprintf(context.output, ",%.17g", value);
+                    }
+                    for (double metric : finished.metrics)
+                    {
+                        fprintf(context.output, ",%.17g", metric);
+                    }
+                    fprintf(context.output, "\n");
+                }
+                if (*context.callback)
+                {
+                    (*context.callback)(point, finished.metrics);
+                }
+                context.result->pointCount++;
+            }
+
+            context.nextPoint++;
+            it = context.finished.erase(it);
+        }
+    }
+
+    void RunPoint(void *contextPointer, size_t index)
+    {
+        SweepContext &context = *static_cast<SweepContext *>(contextPointer);
+        const int pointIndex = static_cast<int>(index);
+
+        try
+        {
+            SweepPoint point(pointIndex, context.params->dimensions, (*context.points)[index]);
+
+            // Every point is single threaded, the parallelism is across points
+            SimulationParameters simParams = *context.simParams;
+            for (size_t d = 0; d < point.getSize(); d++)
+            {
+                ParameterSweep::SetSimulationParameter(simParams, point.getName(d), point.getValue(d));
+            }
+            simParams.threadCount = 1;
+
+            std::unique_ptr<Scenario> scenario = (*context.factory)(simParams, point);
+            BatchRunner batch(&scenario->getSimulation());
+            BatchResult batchResult = batch.Run();
+            std::vector<double> values = (*context.metrics)(*scenario);
+
+            std::lock_guard<std::mutex> lock(context.mutex);
+            context.result->sampleCount += batchResult.sampleCount;
+            context.finished[pointIndex] = {true, std::move(values)};
+            WriteFinishedPoints(context);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(context.mutex);
+            if (!context.error)
+            {
+                context.error = std::current_exception();
+            }
+
+            // Keep later points from waiting on this one forever
+            context.finished[pointIndex] = {};
+            WriteFinishedPoints(context);
+        }
+    }
+}
+
+SweepResult ParameterSweep::Run(const SweepParameters &params, const SweepRowCallback &callback)
+{
+    if (!m_Factory || !m_Metrics)
+    {
+        throw std::invalid_argument("ParameterSweep requires a scenario factory and a metric extractor");
+    }
+
+    const std::vector<std::vector<double>> points = GeneratePoints(params);
+
+    FILE *output = nullptr;
+    if (!params.outputPath.empty())
+    {
+        output = fopen(params.outputPath.c_str(), "w");
+        if (output == nullptr)
+        {
+            throw std::runtime_error("ParameterSweep: cannot open " + params.outputPath + " for writing");
+        }
+        WriteHeader(output, params, m_MetricNames);
+    }
+
+    SweepResult result;
+    SweepContext context{&m_SimParams, &m_Factory, &m_Metrics, &callback, &params, &points, &result, output};
+
+    int threadCount = params.threadCount;
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+    threadCount = static_cast<int>(std::min<size_t>(static_cast<size_t>(threadCount), std::max<size_t>(points.size(), 1)));
+
+    auto wallStart = std::chrono::steady_clock::now();
+
+    if (threadCount <= 1)
+    {
+        for (size_t p = 0; p < points.size(); p++)
+        {
+            RunPoint(&context, p);
+        }
+    }
+    else
+    {
+        // The calling thread takes part in the work, so the pool needs one thread less
+        ThreadPool pool(threadCount - 1);
+        pool.ParallelFor(points.size(), &RunPoint, &context);
+    }
+
+    auto wallEnd = std::chrono::steady_clock::now();
+
+    if (output != nullptr)
+    {
+        fclose(output);
+    }
+
+    if (context.error)
+    {
+        std::rethrow_exception(context.error);
+    }
+
+    result.wallTime = std::chrono::duration<double>(wallEnd - wallStart).count();
+    if (result.wallTime > 0.0)
+    {
+        result.samplesPerSecond = static_cast<double>(result.sampleCount) / result.wallTime;
+    }
+
+    return result;
+}
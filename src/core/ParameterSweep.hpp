@@ -0,0 +1,98 @@
+#pragma once
+
+#include "EnsembleRunner.hpp"
+#include "Scenario.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Range of one swept parameter
+struct SweepDimension
+{
+    std::string name; // SimulationParameters field (e.g. "simTimeStep") or a name understood by the scenario factory
+    double min = 0.0;
+    double max = 0.0;
+    int count = 1; // Grid values spread evenly over [min, max], unused by the Latin hypercube
+};
+
+enum class SweepMode
+{
+    Grid,           // Every combination of the dimensions' values
+    LatinHypercube, // sampleCount points, each dimension's range split in sampleCount strata hit exactly once
+};
+
+struct SweepParameters
+{
+    SweepMode mode = SweepMode::Grid;
+    std::vector<SweepDimension> dimensions;
+    int sampleCount = 0;  // Latin hypercube points
+    uint64_t seed = 0;    // Latin hypercube stratum permutation and jitter
+    int threadCount = 0;  // Points executed in parallel, 0 uses every hardware thread
+    std::string outputPath; // CSV file receiving one row per point, nothing is written if empty
+};
+
+// Values of the swept parameters at one point of a sweep
+class SweepPoint
+{
+public:
+    SweepPoint(int index, const std::vector<SweepDimension> &dimensions, const std::vector<double> &values)
+        : index(index), p_Dimensions(&dimensions), p_Values(&values) {}
+
+    bool Has(const std::string &name) const;
+    double Get(const std::string &name, double fallback) const;
+
+    size_t getSize() const { return p_Values->size(); }
+    const std::string &getName(size_t i) const { return (*p_Dimensions)[i].name; }
+    double getValue(size_t i) const { return (*p_Values)[i]; }
+
+    int index;
+
+private:
+    const std::vector<SweepDimension> *p_Dimensions;
+    const std::vector<double> *p_Values;
+};
+
+struct SweepResult
+{
+    int pointCount = 0;
+    uint64_t sampleCount = 0;      // Samples simulated across all points
+    double wallTime = 0.0;         // sec
+    double samplesPerSecond = 0.0; // Aggregate simulated samples per wall-clock second
+};
+
+// Builds the scenario of a point, the SimulationParameters fields of the point are already applied to params
+using SweepScenarioFactory = std::function<std::unique_ptr<Scenario>(const SimulationParameters &params, const SweepPoint &point)>;
+
+// Called once per finished point, in point order
+using SweepRowCallback = std::function<void(const SweepPoint &point, const std::vector<double> &metrics)>;
+
+// Runs a scenario at every point of a grid or Latin hypercube over named parameters, spreading the points over
+// a thread pool. Rows are emitted in point order whatever the thread count. Immutable tables that don't depend
+// on the swept parameters are shared between points through TableCache::Shared(), tables of past points are freed
+// once no point uses them.
+class ParameterSweep
+{
+public:
+    ParameterSweep(const SimulationParameters &simParams, SweepScenarioFactory factory, MetricExtractor metrics, std::vector<std::string> metricNames)
+        : m_SimParams(simParams), m_Factory(std::move(factory)), m_Metrics(std::move(metrics)), m_MetricNames(std::move(metricNames)) {}
+    virtual ~ParameterSweep() = default;
+
+    virtual SweepResult Run(const SweepParameters &params, const SweepRowCallback &callback = nullptr);
+
+    const std::vector<std::string> &getMetricNames() const { return m_MetricNames; }
+
+    // Values of every point, one row per point and one column per dimension
+    static std::vector<std::vector<double>> GeneratePoints(const SweepParameters &params);
+
+    // Sets the SimulationParameters field called name, returns false if there is no such field
+    static bool SetSimulationParameter(SimulationParameters &params, const std::string &name, double value);
+
+protected:
+    SimulationParameters m_SimParams;
+    SweepScenarioFactory m_Factory;
+    MetricExtractor m_Metrics;
+    std::vector<std::string> m_MetricNames;
+};
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "SimulationObject.hpp"
+#include "StateArchive.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// Complex baseband (I/Q) sample
+using Complex = std::complex<float>;
+
+enum class SampleType
+{
+    Real,
+    Complex,
+};
+
+template <typename T>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<float>
+{
+    static constexpr SampleType type = SampleType::Real;
+};
+
+template <>
+struct SampleTraits<Complex>
+{
+    static constexpr SampleType type = SampleType::Complex;
+};
+
+// A typed, possibly multi-channel connection point of a SimulationObject.
+// Multi-channel buffers are frame interleaved, sample i of channel c is at [i * channels + c].
+class Port
+{
+public:
+    Port(SimulationObject *owner, const std::string &name, SampleType type, int channels)
+        : p_Owner(owner), m_Name(name), m_Type(type), m_Channels(channels) {}
+    virtual ~Port() = default;
+
+    Port(const Port &) = delete;
+    Port &operator=(const Port &) = delete;
+
+    SimulationObject *getOwner() const { return p_Owner; }
+    const std::string &getName() const { return m_Name; }
+    SampleType getType() const { return m_Type; }
+    int getChannels() const { return m_Channels; }
+
+protected:
+    SimulationObject *p_Owner = nullptr;
+    std::string m_Name;
+    SampleType m_Type;
+    int m_Channels = 1;
+};
+
+// Output ports own the edge buffer, it is allocated once by the Simulation and reused every block
+class OutputPortBase : public Port
+{
+public:
+    OutputPortBase(SimulationObject *owner, const std::string &name, SampleType type, int channels)
+        : Port(owner, name, type, channels)
+    {
+        owner->m_Outputs.push_back(this);
+    }
+
+    // Frames per channel the buffer can hold
+    virtual void Allocate(int capacity) = 0;
+    int getCapacity() const { return m_Capacity; }
+
+    // Frames written in the current block
+    int getSampleCount() const { return m_SampleCount; }
+    void setSampleCount(int count) { m_SampleCount = count; }
+
+    // True if at least one input reads this output, objects may skip computing outputs nobody reads
+    bool isConnected() const { return m_ConsumerCount > 0; }
+
+protected:
+    friend class Simulation;
+
+    int m_Capacity = 0;
+    int m_SampleCount = 0;
+    int m_ConsumerCount = 0; // Counted by Simulation::BuildGraph()
+};
+
+// Input ports read directly from the connected output's buffer, nothing is copied
+class InputPortBase : public Port
+{
+public:
+    InputPortBase(SimulationObject *owner, const std::string &name, SampleType type, int channels)
+        : Port(owner, name, type, channels)
+    {
+        owner->m_Inputs.push_back(this);
+    }
+
+    bool isConnected() const { return p_Source != nullptr; }
+    const OutputPortBase *getSource() const { return p_Source; }
+    bool isResampling() const { return m_Resampling; }
+
+    int getSampleCount() const
+    {
+        if (m_Resampling)
+        {
+            return m_SampleCount;
+        }
+        return p_Source != nullptr ? p_Source->getSampleCount() : 0;
+    }
+
+protected:
+    friend class Simulation;
+
+    // Inputs fed from an object running at a different rate hold their own resampled copy of the block
+    virtual void AllocateResampler(int capacity) = 0;
+    virtual void ReleaseResampler() = 0;
+
+    // Zero-order hold: every consumer sample takes the latest producer sample at or before its time
+    virtual void Resample(const SimulationBlock &producerBlock, int producerDecimation, const SimulationBlock &consumerBlock, int consumerDecimation) = 0;
+
+    // The held sample is the only state of a resampling input
+    virtual void SaveResamplerState(StateWriter &writer) const = 0;
+    virtual void LoadResamplerState(StateReader &reader) = 0;
+
+    const OutputPortBase *p_Source = nullptr;
+    bool m_Resampling = false;
+    int m_SampleCount = 0;
+};
+
+template <typename T>
+class OutputPort : public OutputPortBase
+{
+public:
+    OutputPort(SimulationObject *owner, const std::string &name, int channels = 1)
+        : OutputPortBase(owner, name, SampleTraits<T>::type, channels) {}
+
+    void Allocate(int capacity) override
+    {
+        m_Buffer.assign(static_cast<size_t>(capacity) * m_Channels, T{});
+        m_Capacity = capacity;
+    }
+
+    T *Data() { return m_Buffer.data(); }
+    const T *Data() const { return m_Buffer.data(); }
+
+    // Frames written in the current block, all channels interleaved
+    std::span<T> Samples() { return {m_Buffer.data(), static_cast<size_t>(m_SampleCount) * m_Channels}; }
+    std::span<const T> Samples() const { return {m_Buffer.data(), static_cast<size_t>(m_SampleCount) * m_Channels}; }
+
+private:
+    std::vector<T> m_Buffer;
+};
+
+template <typename T>
+class InputPort : public InputPortBase
+{
+public:
+    InputPort(SimulationObject *owner, const std::string &name, int channels = 1)
+        : InputPortBase(owner, name, SampleTraits<T>::type, channels) {}
+
+    // nullptr if the port is not connected
+    const T *Data() const
+    {
+        if (m_Resampling)
+        {
+            return m_Buffer.data();
+        }
+        return p_Source != nullptr ? static_cast<const OutputPort<T> *>(p_Source)->Data() : nullptr;
+    }
+
+    // Frames of the current block, all channels interleaved
+    std::span<const T> Samples() const
+    {
+        if (m_Resampling)
+        {
+            return {m_Buffer.data(), static_cast<size_t>(m_SampleCount) * m_Channels};
+        }
+        if (p_Source == nullptr)
+        {
+            return {};
+        }
+        return static_cast<const OutputPort<T> *>(p_Source)->Samples();
+    }
+
+protected:
+    void AllocateResampler(int capacity) override
+    {
+        // Keep the held sample when the graph is only rebuilt
+        m_Buffer.assign(static_cast<size_t>(capacity) * m_Channels, T{});
+        if (!m_Resampling)
+        {
+            m_Held.assign(m_Channels, T{});
+        }
+        m_Resampling = true;
+    }
+
+    void ReleaseResampler() override
+    {
+        m_Buffer.clear();
+        m_Held.clear();
+        m_Resampling = false;
+    }
+
+    void Resample(const SimulationBlock &producerBlock, int producerDecimation, const SimulationBlock &consumerBlock, int consumerDecimation) override
+    {
+        const T *source = static_cast<const OutputPort<T> *>(p_Source)->Data();
+        const size_t channels = static_cast<size_t>(m_Channels);
+
+        for (int i = 0; i < consumerBlock.nSamples; i++)
+        {
+            // Index of the producer sample at or before this consumer sample, relative to the producer's block
+            const uint64_t baseIndex = (consumerBlock.sampleIndex + i) * consumerDecimation;
+            const int64_t local = static_cast<int64_t>(baseIndex / producerDecimation) - static_cast<int64_t>(producerBlock.sampleIndex);
+
+            const T *frame = local >= 0 ? source + local * channels : m_Held.data();
+            std::copy(frame, frame + channels, m_Buffer.data() + i * channels);
+        }
+        m_SampleCount = consumerBlock.nSamples;
+
+        // Hold the last producer sample for consumer samples early in the next block
+        if (producerBlock.nSamples > 0)
+        {
+            const T *last = source + (producerBlock.nSamples - 1) * channels;
+            std::copy(last, last + channels, m_Held.begin());
+        }
+    }
+
+    void SaveResamplerState(StateWriter &writer) const override
+    {
+        writer.WriteVector(m_Held);
+    }
+
+    void LoadResamplerState(StateReader &reader) override
+    {
+        std::vector<T> held;
+        reader.ReadVector(held);
+        if (held.size() != m_Held.size())
+        {
+            throw std::runtime_error("Input " + m_Name + " state does not match its resampler");
+        }
+        m_Held = held;
+    }
+
+private:
+    std::vector<T> m_Buffer;
+    std::vector<T> m_Held;
+};
@@ -0,0 +1,100 @@
+#include "Random.hpp"
+
+#include "dsp/Gaussian.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr int BatchBlocks = 8;
+
+    // Philox4x32-10 of BatchBlocks consecutive counter blocks. The blocks are independent, so their rounds
+    // overlap in the pipeline. An SSE2 version with pmuludq was no faster, emulating the 32x32->64 bit
+    // multiplies costs as much as the lanes gain.
+    void PhiloxBatch(uint64_t firstBlock, const uint32_t streamId[2], const uint32_t key[2], uint32_t *out)
+    {
+        for (int lane = 0; lane < BatchBlocks; lane++)
+        {
+            const uint64_t block = firstBlock + lane;
+            const uint32_t counter[4] = {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), streamId[0], streamId[1]};
+            Random::Philox4x32(counter, key, out + 4 * lane);
+        }
+    }
+}
+
+void RandomStream::Words(uint64_t index, uint32_t *out, int count) const
+{
+    uint32_t words[4];
+
+    // Head up to the next counter block boundary
+    while (count > 0 && index % 4 != 0)
+    {
+        Block(index / 4, words);
+        const int n = std::min(count, static_cast<int>(4 - index % 4));
+        std::copy(words + index % 4, words + index % 4 + n, out);
+        index += n;
+        out += n;
+        count -= n;
+    }
+
+    for (; count >= 4 * BatchBlocks; count -= 4 * BatchBlocks)
+    {
+        PhiloxBatch(index / 4, m_StreamId, m_Key, out);
+        index += 4 * BatchBlocks;
+        out += 4 * BatchBlocks;
+    }
+
+    for (; count > 0; count -= 4)
+    {
+        Block(index / 4, words);
+        std::copy(words, words + std::min(count, 4), out);
+        index += 4;
+        out += 4;
+    }
+}
+
+void RandomStream::Uniform(uint64_t index, float *out, int count) const
+{
+    constexpr int Chunk = 256;
+    uint32_t words[Chunk];
+    while (count > 0)
+    {
+        const int n = std::min(count, Chunk);
+        Words(index, words, n);
+        for (int i = 0; i < n; i++)
+        {
+            out[i] = Random::ToUniform(words[i]);
+        }
+        index += n;
+        out += n;
+        count -= n;
+    }
+}
+
+void RandomStream::Gaussian(uint64_t index, float *out, int count) const
+{
+    // Value i is value i % 4 of counter block i / 4, so a block may start or end anywhere without changing any
+    // value. Only partial counter blocks at either end go through a scratch block.
+    float values[4];
+    if (count > 0 && index % 4 != 0)
+    {
+        Dsp::PhiloxGaussian(m_Key, m_StreamId, index / 4, values, 1);
+        const int n = std::min(count, static_cast<int>(4 - index % 4));
+        std::copy(values + index % 4, values + index % 4 + n, out);
+        index += n;
+        out += n;
+        count -= n;
+    }
+
+    const int blocks = count / 4;
+    Dsp::PhiloxGaussian(m_Key, m_StreamId, index / 4, out, blocks);
+    index += 4 * static_cast<uint64_t>(blocks);
+    out += 4 * blocks;
+    count -= 4 * blocks;
+
+    if (count > 0)
+    {
+        Dsp::PhiloxGaussian(m_Key, m_StreamId, index / 4, values, 1);
+        std::copy(values, values + count, out);
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+// Counter-based random numbers (Philox4x32-10, Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// Every value is a pure function of (seed, stream, index), so there is no generator state to share, lock or
+// checkpoint, and the numbers an object draws don't depend on the thread count or the block size.
+namespace Random
+{
+    // One Philox4x32-10 evaluation, 4 random words from a 128 bit counter and a 64 bit key
+    inline void Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+    {
+        constexpr uint32_t M0 = 0xD2511F53u;
+        constexpr uint32_t M1 = 0xCD9E8D57u;
+        constexpr uint32_t W0 = 0x9E3779B9u;
+        constexpr uint32_t W1 = 0xBB67AE85u;
+
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; round++)
+        {
+            const uint64_t p0 = static_cast<uint64_t>(M0) * c0;
+            const uint64_t p1 = static_cast<uint64_t>(M1) * c2;
+            const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += W0;
+            k1 += W1;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+    // Uniform in (0, 1], never 0 so it can go through a logarithm
+    inline float ToUniform(uint32_t word)
+    {
+        return static_cast<float>((word >> 8) + 1) * 0x1.0p-24f;
+    }
+}
+
+// Stream of random numbers of one object, value i is a function of (seed, stream id, i) only. Objects use the
+// simulation seed and their object id, and index values by sample index (times channels for multi-channel data),
+// so any block partitioning, any thread and any CPU produces the same numbers.
+class RandomStream
+{
+public:
+    RandomStream(uint64_t seed, uint64_t streamId)
+        : m_Key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          m_StreamId{static_cast<uint32_t>(streamId), static_cast<uint32_t>(streamId >> 32)} {}
+
+    // Random words index, index + 1, ... index + count - 1
+    void Words(uint64_t index, uint32_t *out, int count) const;
+
+    // Uniform values in (0, 1]
+    void Uniform(uint64_t index, float *out, int count) const;
+
+    // Standard normal values (Box-Muller on consecutive pairs of words, see dsp/Gaussian.hpp). Pairs 2m, 2m + 1
+    // are complex normal values, so complex samples can be drawn by reinterpreting them as float pairs.
+    void Gaussian(uint64_t index, float *out, int count) const;
+
+    uint32_t Word(uint64_t index) const
+    {
+        uint32_t words[4];
+        Block(index / 4, words);
+        return words[index % 4];
+    }
+
+private:
+    // The four words of counter block, words 4 * block to 4 * block + 3 of the stream
+    void Block(uint64_t block, uint32_t out[4]) const
+    {
+        const uint32_t counter[4] = {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), m_StreamId[0], m_StreamId[1]};
+        Random::Philox4x32(counter, m_Key, out);
+    }
+
+    uint32_t m_Key[2];
+    uint32_t m_StreamId[2];
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+// Optional interface for anything that draws itself in the GUI.
+// Core simulation code never implements this, so it can be built without the GUI stack.
+class Renderable
+{
+public:
+    virtual ~Renderable() = default;
+
+    virtual void Render() = 0;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Simulation.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+// A Simulation together with the objects it runs, so independent copies of a setup can be built from one description
+class Scenario
+{
+public:
+    Scenario(const SimulationParameters &params) : m_Simulation(params) {}
+    virtual ~Scenario() = default;
+
+    Scenario(const Scenario &) = delete;
+    Scenario &operator=(const Scenario &) = delete;
+
+    // Creates an object owned by the scenario and adds it to the simulation
+    template <typename T, typename... Args>
+    T &AddObject(Args &&...args)
+    {
+        auto object = std::make_unique<T>(std::forward<Args>(args)...);
+        T &reference = *object;
+        m_Simulation.AddObject(object.get());
+        m_Objects.push_back(std::move(object));
+        return reference;
+    }
+
+    Simulation &getSimulation() { return m_Simulation; }
+
+protected:
+    Simulation m_Simulation;
+    std::vector<std::unique_ptr<SimulationObject>> m_Objects;
+};
@@ -1,9 +1,21 @@
 #include "Simulation.hpp"
 
-#include <imgui.h>
+#include "Clock.hpp"
+#include "Port.hpp"
+#include "StateArchive.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iterator>
 #include <stdexcept>
 
+Simulation::~Simulation()
+{
+    Shutdown();
+}
+
 // Simulation management
 void Simulation::Initialize()
 {
@@ -18,13 +30,38 @@ void Simulation::Initialize()
     {
         throw std::invalid_argument("Simulation time step must be greater than 0");
     }
+    if (m_SimParamsCurrent.blockSize <= 0)
+    {
+        throw std::invalid_argument("Simulation block size must be greater than 0");
+    }
+    if (m_SimParamsCurrent.tickPeriod <= 0 || m_SimParamsCurrent.tickPeriod > m_SimParamsCurrent.simTimeStep)
+    {
+        throw std::invalid_argument("Simulation tick period must be greater than 0 and not exceed the time step");
+    }
+
+    BuildGraph();
 }
 
 void Simulation::Reset()
 {
     m_Running = false;
     m_SimParamsCurrent = m_SimParamsInitial;
-    m_SimulationTime = m_SimParamsCurrent.simStartTime;
+    m_Tick = Clock::TimeToTicks(m_SimParamsCurrent.simStartTime, m_SimParamsCurrent.tickPeriod);
+    m_SimulationTime = static_cast<double>(m_Tick) * m_SimParamsCurrent.tickPeriod;
+    m_SampleCount = 0;
+    m_SkippedSampleCount = 0;
+
+    // The time step may have been changed since, and the held samples of resampling inputs belong to the old run.
+    // The next update rebuilds the graph with fresh resamplers.
+    for (auto object : m_Objects)
+    {
+        for (auto input : object->getInputs())
+        {
+            input->ReleaseResampler();
+        }
+        object->Reset();
+    }
+    m_GraphDirty = true;
 }
 
 void Simulation::Finalize()
@@ -46,17 +83,96 @@ void Simulation::Update()
         return;
     }
 
-    // Advance the simulation time
-    m_SimulationTime += m_SimParamsCurrent.simTimeStep;
+    const bool hasEnd = m_SimParamsCurrent.simEndTime > 0.0;
+    const int64_t endTick = hasEnd ? Clock::TimeToTicks(m_SimParamsCurrent.simEndTime, m_SimParamsCurrent.tickPeriod) : ActivityWindow::Never;
+
+    SimulationBlock fullBlock = MakeBlock(std::max(m_SimParamsCurrent.blockSize, 1));
+    int nSamples = fullBlock.nSamples;
+
+    if (m_SimParamsCurrent.eventDriven)
+    {
+        const ActivityWindow window = NextActivity(fullBlock.startTick);
+
+        // Jump to the first sample of the next active window, nothing is processed in between
+        if (window.begin > fullBlock.startTick && (window.begin != ActivityWindow::Never || hasEnd))
+        {
+            const int64_t target = std::min(window.begin, endTick);
+            const int64_t skipped = (target - fullBlock.startTick + fullBlock.ticksPerSample - 1) / fullBlock.ticksPerSample;
+            SkipSamples(skipped, fullBlock.ticksPerSample);
+
+            if (hasEnd && m_Tick >= endTick)
+            {
+                Stop();
+                return;
+            }
+            fullBlock = MakeBlock(nSamples);
+        }
+
+        // The block ends where the set of active objects may change
+        if (window.end != ActivityWindow::Never)
+        {
+            const int64_t active = (window.end - fullBlock.startTick + fullBlock.ticksPerSample - 1) / fullBlock.ticksPerSample;
+            nSamples = static_cast<int>(std::clamp<int64_t>(active, 1, nSamples));
+        }
+    }
+
+    // Process a full block, or only the samples left before the end time if it is set
+    bool reachesEnd = false;
+    if (hasEnd)
+    {
+        const int64_t remaining = (endTick - m_Tick + fullBlock.ticksPerSample - 1) / fullBlock.ticksPerSample;
+        if (remaining <= nSamples)
+        {
+            nSamples = static_cast<int>(std::max<int64_t>(remaining, 1));
+            reachesEnd = true;
+        }
+    }
+
+    const SimulationBlock block = MakeBlock(nSamples);
+    AdvanceClock(block);
 
-    // Stop the simulation if the end time is set and the simulation time has exceeded the end time
-    if (m_SimParamsCurrent.simEndTime > 0.0 && m_SimulationTime >= m_SimParamsCurrent.simEndTime)
+    // Stop the simulation if the end time is set and the simulation time has reached the end time
+    if (reachesEnd)
     {
         Stop();
     }
 
-    // Update all objects if the next time to process doesn't exceed the end time
-    UpdateObjects();
+    // Update all objects
+    UpdateObjects(block);
+}
+
+ActivityWindow Simulation::NextActivity(int64_t tick) const
+{
+    // The merged window starts with the earliest active object and lasts until any object starts or stops
+    ActivityWindow window{ActivityWindow::Never, ActivityWindow::Never};
+    for (auto object : m_Objects)
+    {
+        const ActivityWindow objectWindow = object->NextActivity(tick, m_SimParamsCurrent.tickPeriod);
+        if (objectWindow.begin < window.begin)
+        {
+            // Every object seen so far starts at or after the previous begin
+            window.end = std::min(window.begin, objectWindow.end);
+            window.begin = objectWindow.begin;
+        }
+        else if (objectWindow.begin == window.begin)
+        {
+            window.end = std::min(window.end, objectWindow.end);
+        }
+        else
+        {
+            window.end = std::min(window.end, objectWindow.begin);
+        }
+    }
+    return window;
+}
+
+void Simulation::SkipSamples(int64_t count, int64_t ticksPerSample)
+{
+    // The skipped samples stay on the sample grid, so sample indices and decimated rates remain aligned
+    m_Tick += count * ticksPerSample;
+    m_SimulationTime = static_cast<double>(m_Tick) * m_SimParamsCurrent.tickPeriod;
+    m_SampleCount += static_cast<uint64_t>(count);
+    m_SkippedSampleCount += static_cast<uint64_t>(count);
 }
 
 void Simulation::Step()
@@ -67,26 +183,146 @@ void Simulation::Step()
         return;
     }
 
-    // Advance the simulation time
-    m_SimulationTime += m_SimParamsCurrent.simTimeStep;
+    const SimulationBlock block = MakeBlock(1);
+    AdvanceClock(block);
 
     // Update all objects
-    UpdateObjects();
+    UpdateObjects(block);
 }
 
-void Simulation::UpdateObjects()
+SimulationBlock Simulation::MakeBlock(int nSamples) const
 {
-    for (auto object : m_Objects)
+    // The time step is rounded to whole ticks, time is always derived from the tick count
+    const double tickPeriod = m_SimParamsCurrent.tickPeriod;
+
+    SimulationBlock block;
+    block.ticksPerSample = std::max<int64_t>(Clock::TimeToTicks(m_SimParamsCurrent.simTimeStep, tickPeriod), 1);
+    block.startTick = m_Tick + block.ticksPerSample;
+    block.tickPeriod = tickPeriod;
+    block.t0 = static_cast<double>(block.startTick) * tickPeriod;
+    block.dt = static_cast<double>(block.ticksPerSample) * tickPeriod;
+    block.nSamples = nSamples;
+    block.sampleIndex = m_SampleCount;
+    block.seed = m_SimParamsCurrent.seed;
+    return block;
+}
+
+void Simulation::AdvanceClock(const SimulationBlock &block)
+{
+    m_Tick = block.SampleTick(block.nSamples - 1);
+    m_SimulationTime = static_cast<double>(m_Tick) * block.tickPeriod;
+    m_SampleCount += block.nSamples;
+}
+
+void Simulation::UpdateObjects(const SimulationBlock &block)
+{
+    if (m_GraphDirty || block.nSamples > m_GraphCapacity)
+    {
+        BuildGraph();
+    }
+
+    if (m_ThreadPool != nullptr)
+    {
+        UpdateObjectsParallel(block);
+        return;
+    }
+
+    // Objects run in topological order, so every input is filled before its consumer runs
+    for (size_t i = 0; i < m_Schedule.size(); i++)
+    {
+        ProcessObject(i, block);
+    }
+}
+
+void Simulation::ProcessObject(size_t index, const SimulationBlock &block)
+{
+    SimulationObject *object = m_Schedule[index];
+
+    // Objects only see the samples of the block that fall on their own rate
+    const SimulationBlock objectBlock = block.Decimate(object->m_Decimation);
+
+    for (auto input : object->getInputs())
+    {
+        if (input->m_Resampling)
+        {
+            const int producerDecimation = input->p_Source->getOwner()->m_Decimation;
+            input->Resample(block.Decimate(producerDecimation), producerDecimation, objectBlock, object->m_Decimation);
+        }
+    }
+
+    for (auto output : object->getOutputs())
+    {
+        output->setSampleCount(objectBlock.nSamples);
+    }
+
+    if (objectBlock.nSamples > 0)
+    {
+        object->ProcessBlock(objectBlock);
+    }
+}
+
+void Simulation::UpdateObjectsParallel(const SimulationBlock &block)
+{
+    // An object becomes ready once all of its producers have finished the block. Every object only writes
+    // its own outputs, so the result doesn't depend on which thread runs it or in which order.
+    p_CurrentBlock = &block;
+    m_TaskError = nullptr;
+    m_PendingObjects.store(static_cast<int>(m_Schedule.size()), std::memory_order_relaxed);
+    for (size_t i = 0; i < m_Schedule.size(); i++)
+    {
+        m_PendingInputs[i].store(m_ScheduleInputCount[i], std::memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < m_Schedule.size(); i++)
+    {
+        if (m_ScheduleInputCount[i] == 0)
+        {
+            m_ThreadPool->Submit({&Simulation::RunScheduledObject, this, i});
+        }
+    }
+    m_ThreadPool->WaitFor(m_PendingObjects);
+
+    p_CurrentBlock = nullptr;
+    if (m_TaskError)
+    {
+        std::rethrow_exception(m_TaskError);
+    }
+}
+
+void Simulation::RunScheduledObject(void *context, size_t index)
+{
+    Simulation *simulation = static_cast<Simulation *>(context);
+
+    try
     {
-        object->Update(m_SimParamsCurrent.simTimeStep);
+        simulation->ProcessObject(index, *simulation->p_CurrentBlock);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(simulation->m_TaskErrorMutex);
+        if (!simulation->m_TaskError)
+        {
+            simulation->m_TaskError = std::current_exception();
+        }
     }
+
+    // Release consumers whose inputs are now complete, the most recently released one runs next on this thread
+    for (size_t consumer : simulation->m_ScheduleConsumers[index])
+    {
+        if (simulation->m_PendingInputs[consumer].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            simulation->m_ThreadPool->Submit({&Simulation::RunScheduledObject, simulation, consumer});
+        }
+    }
+
+    simulation->m_PendingObjects.fetch_sub(1, std::memory_order_acq_rel);
 }
 
-void Simulation::RenderObjects()
+void Simulation::PublishObjects()
 {
     for (auto object : m_Objects)
     {
-        object->Render();
+        object->Publish();
     }
 }
 
@@ -95,68 +331,549 @@ void Simulation::Stop()
     m_Running = false;
 }
 
+// Simulation thread
+void Simulation::Launch()
+{
+    if (isLaunched())
+    {
+        return;
+    }
+
+    m_ShutdownRequested = false;
+    m_Worker = std::thread(&Simulation::Run, this);
+}
+
+void Simulation::Shutdown()
+{
+    if (!isLaunched())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_CommandMutex);
+        m_ShutdownRequested = true;
+    }
+    m_CommandSignal.notify_one();
+    m_Worker.join();
+}
+
+void Simulation::PostCommand(const SimulationCommand &command)
+{
+    // Without a simulation thread the command can be executed right away
+    if (!isLaunched())
+    {
+        ExecuteCommand(command);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_CommandMutex);
+        m_Commands.push_back(command);
+    }
+    m_CommandSignal.notify_one();
+}
+
+const SimulationStatus &Simulation::getStatus()
+{
+    // Without a simulation thread the UI owns the simulation, so publish the current state directly
+    if (!isLaunched())
+    {
+        SimulationStatus &status = m_Status.Back();
+        status.params = m_SimParamsCurrent;
+        status.simulationTime = m_SimulationTime;
+        status.running = m_Running;
+        m_Status.Publish();
+    }
+
+    m_Status.Fetch();
+    return m_Status.Front();
+}
+
+void Simulation::Run()
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto lastPublish = Clock::now();
+    bool publishPending = true;
+    std::deque<SimulationCommand> commands;
+
+    while (true)
+    {
+        // Take all pending commands, sleeping until one arrives if there is nothing to simulate
+        {
+            std::unique_lock<std::mutex> lock(m_CommandMutex);
+            if (!m_Running && !publishPending)
+            {
+                m_CommandSignal.wait(lock, [this]
+                                     { return m_ShutdownRequested || !m_Commands.empty(); });
+            }
+            if (m_ShutdownRequested)
+            {
+                break;
+            }
+            commands.swap(m_Commands);
+        }
+
+        for (const auto &command : commands)
+        {
+            ExecuteCommand(command);
+            publishPending = true;
+        }
+        commands.clear();
+
+        for (int i = 0; i < m_SimParamsCurrent.updateCountPerFrame && m_Running; i++)
+        {
+            Update();
+            publishPending = true;
+        }
+
+        // Publish snapshots at a bounded rate so copying state doesn't slow down the simulation
+        auto now = Clock::now();
+        if (publishPending && (!m_Running || std::chrono::duration<double>(now - lastPublish).count() >= m_SimParamsCurrent.publishInterval))
+        {
+            SimulationStatus &status = m_Status.Back();
+            status.params = m_SimParamsCurrent;
+            status.simulationTime = m_SimulationTime;
+            status.running = m_Running;
+            m_Status.Publish();
+
+            PublishObjects();
+
+            lastPublish = now;
+            publishPending = false;
+        }
+    }
+}
+
+void Simulation::ExecuteCommand(const SimulationCommand &command)
+{
+    switch (command.type)
+    {
+    case SimulationCommand::Type::Start:
+        Start();
+        break;
+    case SimulationCommand::Type::Stop:
+        Stop();
+        break;
+    case SimulationCommand::Type::Reset:
+        Reset();
+        break;
+    case SimulationCommand::Type::Step:
+        Step();
+        break;
+    case SimulationCommand::Type::SetTimeStep:
+        if (command.value > 0.0)
+        {
+            m_SimParamsCurrent.simTimeStep = command.value;
+
+            // Decimations derived from native sample rates depend on the time step
+            m_GraphDirty = true;
+        }
+        break;
+    case SimulationCommand::Type::SetUpdateCountPerFrame:
+        if (command.value >= 1.0)
+        {
+            m_SimParamsCurrent.updateCountPerFrame = static_cast<int>(command.value);
+        }
+        break;
+    case SimulationCommand::Type::SetBlockSize:
+        if (command.value >= 1.0)
+        {
+            m_SimParamsCurrent.blockSize = static_cast<int>(command.value);
+        }
+        break;
+    }
+}
+
 // Simulation Object Management
 void Simulation::AddObject(SimulationObject *object)
 {
+    object->m_ObjectId = m_NextObjectId++;
     m_Objects.push_back(object);
+    m_GraphDirty = true;
 }
 
 void Simulation::RemoveObject(SimulationObject *object)
 {
     m_Objects.erase(std::remove(m_Objects.begin(), m_Objects.end(), object), m_Objects.end());
+
+    // Drop every connection to or from the removed object
+    for (auto input : object->getInputs())
+    {
+        input->p_Source = nullptr;
+    }
+    for (auto other : m_Objects)
+    {
+        for (auto input : other->getInputs())
+        {
+            if (input->p_Source != nullptr && input->p_Source->getOwner() == object)
+            {
+                input->p_Source = nullptr;
+            }
+        }
+    }
+
+    m_GraphDirty = true;
 }
 
 void Simulation::ClearObjects()
 {
+    for (auto object : m_Objects)
+    {
+        for (auto input : object->getInputs())
+        {
+            input->p_Source = nullptr;
+        }
+    }
+
     m_Objects.clear();
+    m_NextObjectId = 0;
+    m_Schedule.clear();
+    m_GraphDirty = true;
 }
 
-void Simulation::RenderControls()
+// Dataflow graph
+void Simulation::Connect(OutputPortBase &output, InputPortBase &input)
 {
-    ImGui::Begin("Simulation Controls");
+    if (output.getType() != input.getType())
+    {
+        throw std::invalid_argument("Cannot connect " + output.getName() + " to " + input.getName() + ": sample types differ");
+    }
+    if (output.getChannels() != input.getChannels())
+    {
+        throw std::invalid_argument("Cannot connect " + output.getName() + " to " + input.getName() + ": channel counts differ");
+    }
 
-    if (ImGui::CollapsingHeader("Simulation Parameters"))
+    input.p_Source = &output;
+    m_GraphDirty = true;
+}
+
+void Simulation::Disconnect(InputPortBase &input)
+{
+    input.p_Source = nullptr;
+    m_GraphDirty = true;
+}
+
+void Simulation::BuildGraph()
+{
+    const size_t count = m_Objects.size();
+
+    // Count the inputs of every object that are fed by another object
+    std::vector<int> pendingInputs(count, 0);
+    std::vector<std::vector<size_t>> consumers(count);
+    for (auto object : m_Objects)
     {
-        ImGui::Text("Time Step: %.2f ns", getSimulationDt() * 1e9);
-        if (ImGui::Button("+"))
+        for (auto output : object->getOutputs())
         {
-            getSimulationDt() *= 2;
+            output->m_ConsumerCount = 0;
         }
-        ImGui::SameLine();
-        if (ImGui::Button("-"))
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        for (auto input : m_Objects[i]->getInputs())
         {
-            getSimulationDt() /= 2;
+            if (input->p_Source == nullptr)
+            {
+                continue;
+            }
+
+            auto producer = std::find(m_Objects.begin(), m_Objects.end(), input->p_Source->getOwner());
+            if (producer == m_Objects.end())
+            {
+                throw std::logic_error("Input " + input->getName() + " is connected to an object that is not part of the simulation");
+            }
+
+            consumers[producer - m_Objects.begin()].push_back(i);
+            pendingInputs[i]++;
+            const_cast<OutputPortBase *>(input->p_Source)->m_ConsumerCount++;
         }
+    }
 
-        // plus and minus buttons to increment/decrement update count per frame
-        ImGui::Text("Update Count Per Frame: %d", getUpdateCountPerFrame());
-        ImGui::InputInt("##updateCountPerFrame", &getUpdateCountPerFrame(), 1, 5);
+    // Kahn's algorithm, always picking the earliest added ready object so the order is deterministic
+    std::vector<bool> scheduled(count, false);
+    m_Schedule.clear();
+    m_Schedule.reserve(count);
+    while (m_Schedule.size() < count)
+    {
+        size_t next = count;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!scheduled[i] && pendingInputs[i] == 0)
+            {
+                next = i;
+                break;
+            }
+        }
+
+        if (next == count)
+        {
+            throw std::logic_error("Simulation graph contains a cycle");
+        }
 
-        ImGui::Text("Start Time: %.2f ns", getSimulationStartTime() * 1e9);
-        ImGui::Text("End Time: %.2f ns", getSimulationEndTime() * 1e9);
+        scheduled[next] = true;
+        m_Schedule.push_back(m_Objects[next]);
+        for (size_t consumer : consumers[next])
+        {
+            pendingInputs[consumer]--;
+        }
     }
 
-    // Display simulation control
-    if (ImGui::CollapsingHeader("Simulation Control"))
+    // Dependencies in schedule order for the parallel scheduler
+    std::vector<size_t> position(count);
+    for (size_t i = 0; i < count; i++)
     {
-        if (ImGui::Button("Start"))
+        position[std::find(m_Objects.begin(), m_Objects.end(), m_Schedule[i]) - m_Objects.begin()] = i;
+    }
+    m_ScheduleConsumers.assign(count, {});
+    m_ScheduleInputCount.assign(count, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t consumer : consumers[i])
         {
-            Start();
+            m_ScheduleConsumers[position[i]].push_back(position[consumer]);
+            m_ScheduleInputCount[position[consumer]]++;
         }
-        ImGui::SameLine();
-        if (ImGui::Button("Reset"))
+    }
+    m_PendingInputs = std::make_unique<std::atomic<int>[]>(count);
+
+    // The thread updating the simulation takes part in the work, so the pool needs one thread less
+    int threadCount = m_SimParamsCurrent.threadCount;
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+    if (threadCount <= 1)
+    {
+        m_ThreadPool.reset();
+    }
+    else if (m_ThreadPool == nullptr || m_ThreadPool->getThreadCount() != threadCount - 1)
+    {
+        m_ThreadPool = std::make_unique<ThreadPool>(threadCount - 1);
+    }
+
+    // Resolve object rates, native sample rates map to the nearest decimation of the base rate
+    for (auto object : m_Objects)
+    {
+        if (object->m_SampleRate > 0.0)
         {
-            Reset();
+            const double decimation = std::round(1.0 / (m_SimParamsCurrent.simTimeStep * object->m_SampleRate));
+            object->m_Decimation = static_cast<int>(std::max(decimation, 1.0));
         }
-        ImGui::SameLine();
-        if (ImGui::Button("Stop"))
+    }
+
+    // Edge buffers are sized for a full block at the producer's rate once and reused, inputs fed from another
+    // rate get a resampling buffer at the consumer's rate
+    m_GraphCapacity = std::max(m_SimParamsCurrent.blockSize, 1);
+    for (auto object : m_Objects)
+    {
+        const int capacity = (m_GraphCapacity + object->m_Decimation - 1) / object->m_Decimation;
+        for (auto output : object->getOutputs())
+        {
+            output->Allocate(capacity);
+        }
+        for (auto input : object->getInputs())
+        {
+            if (input->p_Source != nullptr && input->p_Source->getOwner()->m_Decimation != object->m_Decimation)
+            {
+                input->AllocateResampler(capacity);
+            }
+            else
+            {
+                input->ReleaseResampler();
+            }
+        }
+    }
+
+    m_GraphDirty = false;
+}
+
+// Checkpoint/restore
+namespace
+{
+    constexpr uint32_t StateMagic = 0x53434D44; // "DMCS"
+    constexpr uint32_t StateVersion = 3;
+
+    // Field by field, so padding never ends up in the checkpoint
+    void WriteParameters(StateWriter &writer, const SimulationParameters &params)
+    {
+        writer.Write(params.simTimeStep);
+        writer.Write(params.simStartTime);
+        writer.Write(params.simEndTime);
+        writer.Write(params.updateCountPerFrame);
+        writer.Write(params.publishInterval);
+        writer.Write(params.blockSize);
+        writer.Write(params.tickPeriod);
+        writer.Write(params.seed);
+        writer.Write(params.threadCount);
+        writer.Write(params.eventDriven);
+    }
+
+    SimulationParameters ReadParameters(StateReader &reader)
+    {
+        SimulationParameters params;
+        reader.Read(params.simTimeStep);
+        reader.Read(params.simStartTime);
+        reader.Read(params.simEndTime);
+        reader.Read(params.updateCountPerFrame);
+        reader.Read(params.publishInterval);
+        reader.Read(params.blockSize);
+        reader.Read(params.tickPeriod);
+        reader.Read(params.seed);
+        reader.Read(params.threadCount);
+        reader.Read(params.eventDriven);
+        return params;
+    }
+}
+
+std::vector<uint8_t> Simulation::SaveState()
+{
+    if (m_GraphDirty)
+    {
+        BuildGraph();
+    }
+
+    StateWriter writer;
+    writer.Write(StateMagic);
+    writer.Write(StateVersion);
+    WriteParameters(writer, m_SimParamsCurrent);
+    writer.Write(m_Tick);
+    writer.Write(m_SampleCount);
+    writer.Write(m_SkippedSampleCount);
+    writer.Write<uint64_t>(m_Objects.size());
+
+    // Every object gets its own length prefixed section so a mismatched restore is detected
+    for (auto object : m_Objects)
+    {
+        StateWriter objectWriter;
+        for (auto input : object->getInputs())
+        {
+            if (input->m_Resampling)
+            {
+                input->SaveResamplerState(objectWriter);
+            }
+        }
+        object->SaveState(objectWriter);
+        writer.WriteBytes(objectWriter.getData());
+    }
+
+    return std::move(writer.getData());
+}
+
+struct Simulation::Checkpoint
+{
+    SimulationParameters params;
+    int64_t tick = 0;
+    uint64_t sampleCount = 0;
+    uint64_t skippedSampleCount = 0;
+    std::vector<std::vector<uint8_t>> objectStates; // One section per object, in the order of m_Objects
+};
+
+Simulation::Checkpoint Simulation::ReadCheckpoint(const std::vector<uint8_t> &state) const
+{
+    StateReader reader(state);
+    if (reader.Read<uint32_t>() != StateMagic)
+    {
+        throw std::runtime_error("Simulation state is not a simulation checkpoint");
+    }
+    if (reader.Read<uint32_t>() != StateVersion)
+    {
+        throw std::runtime_error("Simulation state version is not supported");
+    }
+
+    Checkpoint checkpoint;
+    checkpoint.params = ReadParameters(reader);
+    reader.Read(checkpoint.tick);
+    reader.Read(checkpoint.sampleCount);
+    reader.Read(checkpoint.skippedSampleCount);
+    if (reader.Read<uint64_t>() != m_Objects.size())
+    {
+        throw std::runtime_error("Simulation state was saved with a different number of objects");
+    }
+
+    checkpoint.objectStates.resize(m_Objects.size());
+    for (std::vector<uint8_t> &objectState : checkpoint.objectStates)
+    {
+        reader.ReadBytes(objectState);
+    }
+    if (!reader.isAtEnd())
+    {
+        throw std::runtime_error("Simulation state has data after its last object");
+    }
+    return checkpoint;
+}
+
+void Simulation::ApplyCheckpoint(const Checkpoint &checkpoint)
+{
+    // The graph depends on the restored parameters (block size, rates, threads)
+    m_Running = false;
+    m_SimParamsCurrent = checkpoint.params;
+    BuildGraph();
+
+    for (size_t i = 0; i < m_Objects.size(); i++)
+    {
+        SimulationObject *object = m_Objects[i];
+        StateReader objectReader(checkpoint.objectStates[i]);
+        for (auto input : object->getInputs())
         {
-            Stop();
+            if (input->m_Resampling)
+            {
+                input->LoadResamplerState(objectReader);
+            }
+        }
+        object->LoadState(objectReader);
+
+        if (!objectReader.isAtEnd())
+        {
+            throw std::runtime_error("Simulation state does not match the objects of the simulation");
         }
     }
 
-    // Display simulation time in nanoseconds
-    ImGui::Text("Simulation Time: %.2f ns", getSimulationTime() * 1e9);
+    // The clock only moves once every object is on the checkpoint
+    m_Tick = checkpoint.tick;
+    m_SimulationTime = static_cast<double>(m_Tick) * m_SimParamsCurrent.tickPeriod;
+    m_SampleCount = checkpoint.sampleCount;
+    m_SkippedSampleCount = checkpoint.skippedSampleCount;
+}
+
+void Simulation::LoadState(const std::vector<uint8_t> &state)
+{
+    const Checkpoint checkpoint = ReadCheckpoint(state);
+
+    // An object can still reject its section halfway through, the current state is put back in that case so a
+    // failed restore leaves the simulation as it was
+    const Checkpoint previous = ReadCheckpoint(SaveState());
+    try
+    {
+        ApplyCheckpoint(checkpoint);
+    }
+    catch (...)
+    {
+        ApplyCheckpoint(previous);
+        throw;
+    }
+}
+
+void Simulation::SaveStateToFile(const std::string &path)
+{
+    const std::vector<uint8_t> state = SaveState();
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(state.data()), static_cast<std::streamsize>(state.size()));
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write simulation state to " + path);
+    }
+}
+
+void Simulation::LoadStateFromFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open simulation state " + path);
+    }
 
-    ImGui::End();
+    std::vector<uint8_t> state((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    LoadState(state);
 }
@@ -1,22 +1,65 @@
 #pragma once
 
 #include "SimulationObject.hpp"
+#include "ThreadPool.hpp"
+#include "TripleBuffer.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 struct SimulationParameters
 {
-    double simTimeStep = 1.0 / 60.0;   // 60 Hz / 16.6667 ms
+    double simTimeStep = 1.0 / 60.0;   // 60 Hz / 16.6667 ms, rounded to a whole number of ticks
     double simStartTime = 0.0;   // sec (0 sec)
     double simEndTime = -1.0;    // By default, the simulation will run indefinitely
-    int updateCountPerFrame = 1; // 1 update per frame
+    int updateCountPerFrame = 1; // 1 update per frame (per command check when running on the simulation thread)
+    double publishInterval = 1.0 / 60.0; // sec (wall-clock) between snapshots published by the simulation thread
+    int blockSize = 1;           // Samples processed by each object per update
+    double tickPeriod = 1e-12;   // sec (1 ps) resolution of the simulation clock
+    uint64_t seed = 0;           // Base seed of every random stream in the simulation
+    int threadCount = 1;         // Threads updating independent objects in parallel, 0 uses every hardware thread
+    bool eventDriven = false;    // Jump over samples in which no object is active, see SimulationObject::NextActivity()
+};
+
+// Commands sent from the UI to the simulation thread
+struct SimulationCommand
+{
+    enum class Type
+    {
+        Start,
+        Stop,
+        Reset,
+        Step,
+        SetTimeStep,
+        SetUpdateCountPerFrame,
+        SetBlockSize,
+    };
+
+    Type type = Type::Stop;
+    double value = 0.0;
+};
+
+// Snapshot of the simulation state published for the UI
+struct SimulationStatus
+{
+    SimulationParameters params;
+    double simulationTime = 0.0;
+    bool running = false;
 };
 
 class Simulation
 {
 public:
     Simulation(const SimulationParameters &params) : m_SimParamsInitial(params), m_SimParamsCurrent(params) {}
-    virtual ~Simulation() = default;
+    virtual ~Simulation();
 
     // Simulation management
     virtual void Initialize();
@@ -29,27 +72,92 @@ public:
     virtual void Step();
     virtual void Stop();
 
+    // Simulation thread, while it is launched all control must go through PostCommand()
+    virtual void Launch();
+    virtual void Shutdown();
+    virtual void PostCommand(const SimulationCommand &command);
+    bool isLaunched() const { return m_Worker.joinable(); }
+
+    // Latest published status, only call from the UI thread
+    const SimulationStatus &getStatus();
+
     // Simulation Object Management
     virtual void AddObject(SimulationObject *object);
     virtual void RemoveObject(SimulationObject *object);
-    virtual void UpdateObjects();
-    virtual void RenderObjects();
+    virtual void UpdateObjects(const SimulationBlock &block);
+    virtual void PublishObjects();
     virtual void ClearObjects();
 
-    // Rendering
-    virtual void RenderControls();
+    // Dataflow graph, connections may only be changed while the simulation thread is not launched
+    virtual void Connect(OutputPortBase &output, InputPortBase &input);
+    virtual void Disconnect(InputPortBase &input);
+    virtual void BuildGraph();
+
+    // Checkpoint/restore of the clock, parameters and the state of every object. Restoring requires a simulation
+    // built with the same objects, added in the same order. Only use these while the simulation thread is not launched.
+    // A checkpoint that fails to restore throws and leaves the simulation as it was.
+    virtual std::vector<uint8_t> SaveState();
+    virtual void LoadState(const std::vector<uint8_t> &state);
+    virtual void SaveStateToFile(const std::string &path);
+    virtual void LoadStateFromFile(const std::string &path);
 
     virtual double &getSimulationDt() { return m_SimParamsCurrent.simTimeStep; }
     virtual double &getSimulationStartTime() { return m_SimParamsCurrent.simStartTime; }
     virtual double &getSimulationEndTime() { return m_SimParamsCurrent.simEndTime; }
     virtual double &getSimulationTime() { return m_SimulationTime; }
+    int64_t getSimulationTick() const { return m_Tick; }
     virtual int &getUpdateCountPerFrame() { return m_SimParamsCurrent.updateCountPerFrame; }
+    virtual int &getBlockSize() { return m_SimParamsCurrent.blockSize; }
+    uint64_t getSampleCount() const { return m_SampleCount; }
+    uint64_t getSkippedSampleCount() const { return m_SkippedSampleCount; }
+
+    bool isRunning() const { return m_Running; }
 
 protected:
+    virtual void Run();
+    virtual void ExecuteCommand(const SimulationCommand &command);
+    SimulationBlock MakeBlock(int nSamples) const;
+    void AdvanceClock(const SimulationBlock &block);
+    ActivityWindow NextActivity(int64_t tick) const;
+    void SkipSamples(int64_t count, int64_t ticksPerSample);
+    virtual void UpdateObjectsParallel(const SimulationBlock &block);
+    void ProcessObject(size_t index, const SimulationBlock &block);
+    static void RunScheduledObject(void *context, size_t index);
+
+    // A checkpoint split into its parts, so it is checked completely before anything is replaced
+    struct Checkpoint;
+    Checkpoint ReadCheckpoint(const std::vector<uint8_t> &state) const;
+    void ApplyCheckpoint(const Checkpoint &checkpoint);
+
     SimulationParameters m_SimParamsInitial;
     SimulationParameters m_SimParamsCurrent;
     bool m_Running = false;
-    double m_SimulationTime = 0.0;
+    double m_SimulationTime = 0.0; // Derived from m_Tick, never accumulated
+    int64_t m_Tick = 0;            // Simulation clock in ticks of tickPeriod since t = 0
+    uint64_t m_SampleCount = 0; // Samples simulated since the last reset
+    uint64_t m_SkippedSampleCount = 0; // Samples of m_SampleCount jumped over in discrete-event mode
 
     std::vector<SimulationObject *> m_Objects;
-};
\ No newline at end of file
+    uint64_t m_NextObjectId = 0;
+    std::vector<SimulationObject *> m_Schedule; // m_Objects in topological order
+    bool m_GraphDirty = true;
+    int m_GraphCapacity = 0; // Frames per channel allocated for every edge buffer
+
+    // Parallel object updates, only used with more than one thread
+    std::unique_ptr<ThreadPool> m_ThreadPool;
+    std::vector<std::vector<size_t>> m_ScheduleConsumers; // Indices into m_Schedule
+    std::vector<int> m_ScheduleInputCount;
+    std::unique_ptr<std::atomic<int>[]> m_PendingInputs;
+    std::atomic<int> m_PendingObjects{0};
+    const SimulationBlock *p_CurrentBlock = nullptr;
+    std::mutex m_TaskErrorMutex;
+    std::exception_ptr m_TaskError;
+
+    // Simulation thread
+    std::thread m_Worker;
+    std::atomic<bool> m_ShutdownRequested{false};
+    std::mutex m_CommandMutex;
+    std::condition_variable m_CommandSignal;
+    std::deque<SimulationCommand> m_Commands;
+    TripleBuffer<SimulationStatus> m_Status;
+};
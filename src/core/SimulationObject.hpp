@@ -1,20 +1,136 @@
 #pragma once
 
-#include <implot.h>
-
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
+// A block of consecutive time steps processed in one call.
+// Time is counted in integer ticks of tickPeriod, t0 and dt are derived from them for convenience.
+struct SimulationBlock
+{
+    double t0 = 0.0;             // sec, time of the first sample in the block
+    double dt = 0.0;             // sec, time between samples
+    int nSamples = 0;            // Number of samples in the block
+    uint64_t sampleIndex = 0;    // Index of the first sample since the simulation was reset, at the block's rate
+    int64_t startTick = 0;       // Tick of the first sample in the block
+    int64_t ticksPerSample = 0;  // Ticks between samples
+    double tickPeriod = 0.0;     // sec, duration of one tick
+    uint64_t seed = 0;           // Simulation seed, objects key their RandomStream with it and their object id
+
+    int64_t SampleTick(int i) const { return startTick + i * ticksPerSample; }
+    double SampleTime(int i) const { return static_cast<double>(SampleTick(i)) * tickPeriod; }
+
+    // The samples of this block that fall on every decimation-th sample
+    SimulationBlock Decimate(int decimation) const
+    {
+        if (decimation <= 1)
+        {
+            return *this;
+        }
+
+        const uint64_t first = (sampleIndex + decimation - 1) / decimation;
+        const uint64_t end = (sampleIndex + nSamples + decimation - 1) / decimation;
+
+        SimulationBlock block = *this;
+        block.startTick = startTick + static_cast<int64_t>(first * decimation - sampleIndex) * ticksPerSample;
+        block.ticksPerSample = ticksPerSample * decimation;
+        block.t0 = static_cast<double>(block.startTick) * tickPeriod;
+        block.dt = static_cast<double>(block.ticksPerSample) * tickPeriod;
+        block.nSamples = static_cast<int>(end - first);
+        block.sampleIndex = first;
+        return block;
+    }
+};
+
+// Span of ticks [begin, end) in which an object has something to do, used by the discrete-event mode
+struct ActivityWindow
+{
+    static constexpr int64_t Never = std::numeric_limits<int64_t>::max();
+
+    int64_t begin = 0;
+    int64_t end = Never;
+};
+
+class InputPortBase;
+class OutputPortBase;
+class StateReader;
+class StateWriter;
+
 class SimulationObject
 {
 public:
+    SimulationObject() = default;
+    virtual ~SimulationObject() = default;
+
+    // Ports point back at their owner, so objects can't be copied
+    SimulationObject(const SimulationObject &) = delete;
+    SimulationObject &operator=(const SimulationObject &) = delete;
+
     // Required functions to implement
     virtual void Initialize() = 0;
-    virtual void Update(double dt) = 0;
-    virtual void Render() = 0;
     virtual void Finalize() = 0;
     virtual void Reset() = 0;
+
+    // Per-sample update, only used by the default ProcessBlock(). Objects with ports override ProcessBlock() instead.
+    virtual void Update(double dt) {}
+
+    // Processes a whole block of samples at once, override this for anything that can be vectorized.
+    // Inputs hold block.nSamples frames and outputs must be filled with as many.
+    // The default falls back to one Update() call per sample.
+    virtual void ProcessBlock(const SimulationBlock &block)
+    {
+        for (int i = 0; i < block.nSamples; i++)
+        {
+            Update(block.dt);
+        }
+    }
+
+    // Discrete-event mode, the first window at or after tick in which the object is active (a pulse is transmitted,
+    // a receive window is open). The simulation jumps over ticks in which no object is active, those samples are
+    // never processed. Objects are always active by default, passive objects that only react to their inputs
+    // (displays, recorders) return {Never, Never} so they don't keep the simulation busy.
+    virtual ActivityWindow NextActivity(int64_t tick, double tickPeriod) const { return {tick, ActivityWindow::Never}; }
+
+    // Called on the simulation thread to publish a snapshot of the object's state for the UI
+    virtual void Publish() {}
+
+    // Checkpointing, objects with state that carries over between blocks (buffers, delay lines, trackers)
+    // must write all of it and read it back in the same order
+    virtual void SaveState(StateWriter &writer) const {}
+    virtual void LoadState(StateReader &reader) {}
+
+    // Ports register themselves here when they are constructed as members of the object
+    const std::vector<InputPortBase *> &getInputs() const { return m_Inputs; }
+    const std::vector<OutputPortBase *> &getOutputs() const { return m_Outputs; }
+
+    // Objects may run slower than the simulation's base rate, either on every decimation-th base sample or on
+    // the decimation nearest to a native sample rate. Inputs connected across rates are resampled by the Simulation.
+    void setDecimation(int decimation)
+    {
+        m_Decimation = decimation > 1 ? decimation : 1;
+        m_SampleRate = 0.0;
+    }
+    void setSampleRate(double sampleRate) { m_SampleRate = sampleRate; }
+    int getDecimation() const { return m_Decimation; }
+    double getSampleRate() const { return m_SampleRate; }
+
+    // Identifies the object's random streams. Simulation::AddObject() numbers objects in the order they are added,
+    // call this afterwards to keep an object's numbers independent of the other objects.
+    void setObjectId(uint64_t objectId) { m_ObjectId = objectId; }
+    uint64_t getObjectId() const { return m_ObjectId; }
+
+private:
+    friend class InputPortBase;
+    friend class OutputPortBase;
+    friend class Simulation;
+
+    std::vector<InputPortBase *> m_Inputs;
+    std::vector<OutputPortBase *> m_Outputs;
+    int m_Decimation = 1;
+    double m_SampleRate = 0.0; // Hz, 0 when the decimation was set directly
+    uint64_t m_ObjectId = 0;
 };
 
 // This is here for convenience to create a new SimulationObject
@@ -24,7 +140,6 @@ class SimulationObjectTemplate : public SimulationObject
 public:
     void Initialize() override;
     void Update(double dt) override;
-    void Render() override;
     void Finalize() override;
     void Reset() override;
 };
@@ -41,10 +156,6 @@ void SimulationObjectTemplate::Update(double dt)
 {
 }
 
-void SimulationObjectTemplate::Render()
-{
-}
-
 void SimulationObjectTemplate::Finalize()
 {
 }
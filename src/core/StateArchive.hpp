@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Compact binary serialization of simulation state, values are stored in native byte order
+class StateWriter
+{
+public:
+    template <typename T>
+    void Write(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "StateWriter can only write trivially copyable values");
+        const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+        m_Data.insert(m_Data.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    void WriteVector(const std::vector<T> &values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "StateWriter can only write trivially copyable values");
+        Write<uint64_t>(values.size());
+        const auto *bytes = reinterpret_cast<const uint8_t *>(values.data());
+        m_Data.insert(m_Data.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    void WriteString(const std::string &value)
+    {
+        Write<uint64_t>(value.size());
+        m_Data.insert(m_Data.end(), value.begin(), value.end());
+    }
+
+    void WriteBytes(const std::vector<uint8_t> &bytes) { WriteVector(bytes); }
+
+    const std::vector<uint8_t> &getData() const { return m_Data; }
+    std::vector<uint8_t> &getData() { return m_Data; }
+
+private:
+    std::vector<uint8_t> m_Data;
+};
+
+class StateReader
+{
+public:
+    StateReader(const uint8_t *data, size_t size) : p_Data(data), m_Size(size) {}
+    StateReader(const std::vector<uint8_t> &data) : p_Data(data.data()), m_Size(data.size()) {}
+
+    template <typename T>
+    void Read(T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "StateReader can only read trivially copyable values");
+        Require(sizeof(T));
+        std::memcpy(&value, p_Data + m_Offset, sizeof(T));
+        m_Offset += sizeof(T);
+    }
+
+    template <typename T>
+    T Read()
+    {
+        T value{};
+        Read(value);
+        return value;
+    }
+
+    template <typename T>
+    void ReadVector(std::vector<T> &values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "StateReader can only read trivially copyable values");
+        const uint64_t count = Read<uint64_t>();
+        if (count > (m_Size - m_Offset) / sizeof(T))
+        {
+            throw std::runtime_error("StateReader: unexpected end of state");
+        }
+        values.resize(count);
+        std::memcpy(values.data(), p_Data + m_Offset, count * sizeof(T));
+        m_Offset += count * sizeof(T);
+    }
+
+    std::string ReadString()
+    {
+        const uint64_t size = Read<uint64_t>();
+        Require(size);
+        std::string value(reinterpret_cast<const char *>(p_Data + m_Offset), size);
+        m_Offset += size;
+        return value;
+    }
+
+    void ReadBytes(std::vector<uint8_t> &bytes) { ReadVector(bytes); }
+
+    bool isAtEnd() const { return m_Offset == m_Size; }
+
+private:
+    void Require(uint64_t size) const
+    {
+        if (size > m_Size - m_Offset)
+        {
+            throw std::runtime_error("StateReader: unexpected end of state");
+        }
+    }
+
+    const uint8_t *p_Data = nullptr;
+    size_t m_Size = 0;
+    size_t m_Offset = 0;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Thread-safe cache of immutable precomputed tables (lookup tables, replicas, calibrations) keyed by name.
+// Objects of different simulations share one table instead of each building its own, e.g. across the points
+// of a parameter sweep or the runs of an ensemble. Tables are never modified once built, so they can be read
+// without locking.
+//
+// The cache only holds weak references, a table lives as long as an object uses it. The most recently requested
+// tables are kept alive on top of that (see setRetainedCount()), so users that follow one another, like sweep
+// points run one after the other, still share them. Everything else is freed as soon as its last user releases
+// it, so tables of settings that change all the time (sweep points, UI sliders) don't pile up.
+class TableCache
+{
+public:
+    static constexpr size_t DefaultRetainedCount = 8;
+
+    // Process-wide cache
+    static TableCache &Shared()
+    {
+        static TableCache cache;
+        return cache;
+    }
+
+    // Returns the table stored under key, building it with build() if it doesn't exist (any more). Concurrent
+    // callers may build the same table twice, only the first one stored is kept and returned to everyone.
+    template <typename T, typename Build>
+    std::shared_ptr<const T> GetOrBuild(const std::string &key, Build &&build)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto it = m_Tables.find(key);
+            if (it != m_Tables.end())
+            {
+                std::shared_ptr<const void> table = it->second.table.lock();
+                if (table != nullptr)
+                {
+                    Check<T>(key, it->second);
+                    Retain(table);
+                    return std::static_pointer_cast<const T>(table);
+                }
+            }
+        }
+
+        // Build outside the lock so unrelated tables don't wait on each other
+        std::shared_ptr<const T> built = std::make_shared<const T>(build());
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Tables.find(key);
+        std::shared_ptr<const void> table = it != m_Tables.end() ? it->second.table.lock() : nullptr;
+        if (table == nullptr)
+        {
+            // New or expired, also a good moment to forget the other expired entries
+            PruneExpired();
+            it = m_Tables.insert_or_assign(key, Entry{std::type_index(typeid(T)), built}).first;
+            table = built;
+        }
+        Check<T>(key, it->second);
+        Retain(table);
+        return std::static_pointer_cast<const T>(table);
+    }
+
+    // Tables kept alive after their last user released them, the least recently requested ones go first
+    void setRetainedCount(size_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_RetainedCount = count;
+        if (m_Retained.size() > count)
+        {
+            m_Retained.resize(count);
+        }
+    }
+
+    // Drops every table, tables still referenced by objects stay alive until released
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tables.clear();
+        m_Retained.clear();
+    }
+
+    // Tables currently alive
+    size_t getSize()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        PruneExpired();
+        return m_Tables.size();
+    }
+
+private:
+    struct Entry
+    {
+        std::type_index type = std::type_index(typeid(void));
+        std::weak_ptr<const void> table;
+    };
+
+    template <typename T>
+    static void Check(const std::string &key, const Entry &entry)
+    {
+        if (entry.type != std::type_index(typeid(T)))
+        {
+            throw std::logic_error("TableCache: table '" + key + "' was stored with a different type");
+        }
+    }
+
+    // Moves table to the front of the retained tables, called with the mutex held
+    void Retain(const std::shared_ptr<const void> &table)
+    {
+        auto it = std::find(m_Retained.begin(), m_Retained.end(), table);
+        if (it != m_Retained.end())
+        {
+            std::rotate(m_Retained.begin(), it, it + 1);
+            return;
+        }
+        if (m_RetainedCount == 0)
+        {
+            return;
+        }
+        if (m_Retained.size() >= m_RetainedCount)
+        {
+            m_Retained.pop_back();
+        }
+        m_Retained.insert(m_Retained.begin(), table);
+    }
+
+    // Called with the mutex held
+    void PruneExpired()
+    {
+        for (auto it = m_Tables.begin(); it != m_Tables.end();)
+        {
+            it = it->second.table.expired() ? m_Tables.erase(it) : std::next(it);
+        }
+    }
+
+    std::mutex m_Mutex;
+    std::unordered_map<std::string, Entry> m_Tables;
+    std::vector<std::shared_ptr<const void>> m_Retained; // Most recently requested first
+    size_t m_RetainedCount = DefaultRetainedCount;
+};
@@ -0,0 +1,165 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // Which pool and queue the current thread works for, workers only
+    thread_local const ThreadPool *t_Pool = nullptr;
+    thread_local size_t t_QueueIndex = 0;
+}
+
+ThreadPool::ThreadPool(int threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+    for (int i = 0; i <= threadCount; i++)
+    {
+        m_Queues.push_back(std::make_unique<Queue>());
+    }
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        m_Threads.emplace_back(&ThreadPool::WorkerLoop, this, static_cast<size_t>(i));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Stop = true;
+    }
+    m_WakeSignal.notify_all();
+
+    for (auto &thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::Submit(const ThreadPoolTask &task)
+{
+    Queue &queue = *m_Queues[CurrentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+    m_QueuedCount.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_WakeSignal.notify_one();
+}
+
+void ThreadPool::WaitFor(const std::atomic<int> &pending)
+{
+    const size_t index = CurrentQueue();
+    ThreadPoolTask task;
+
+    while (pending.load(std::memory_order_acquire) > 0)
+    {
+        if (TryPop(index, task) || TrySteal(index, task))
+        {
+            task.function(task.context, task.index);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, void (*function)(void *context, size_t index), void *context)
+{
+    struct Batch
+    {
+        void (*function)(void *context, size_t index);
+        void *context;
+        std::atomic<int> pending;
+    };
+
+    Batch batch{function, context, static_cast<int>(count)};
+    auto run = [](void *batchContext, size_t index)
+    {
+        Batch *batch = static_cast<Batch *>(batchContext);
+        batch->function(batch->context, index);
+        batch->pending.fetch_sub(1, std::memory_order_acq_rel);
+    };
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Submit({run, &batch, i});
+    }
+    WaitFor(batch.pending);
+}
+
+void ThreadPool::WorkerLoop(size_t index)
+{
+    t_Pool = this;
+    t_QueueIndex = index;
+
+    ThreadPoolTask task;
+    while (true)
+    {
+        if (TryPop(index, task) || TrySteal(index, task))
+        {
+            task.function(task.context, task.index);
+            continue;
+        }
+
+        // Sleep until something is submitted
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_WakeSignal.wait(lock, [this]
+                          { return m_Stop || m_QueuedCount.load(std::memory_order_acquire) > 0; });
+        if (m_Stop)
+        {
+            break;
+        }
+    }
+}
+
+bool ThreadPool::TryPop(size_t index, ThreadPoolTask &task)
+{
+    Queue &queue = *m_Queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::TrySteal(size_t index, ThreadPoolTask &task)
+{
+    const size_t count = m_Queues.size();
+    for (size_t offset = 1; offset < count; offset++)
+    {
+        Queue &queue = *m_Queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            continue;
+        }
+
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+size_t ThreadPool::CurrentQueue() const
+{
+    // Threads outside the pool share the injection queue
+    return t_Pool == this ? t_QueueIndex : m_Queues.size() - 1;
+}
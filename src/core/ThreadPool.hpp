@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Allocation free unit of work, function(context, index)
+struct ThreadPoolTask
+{
+    void (*function)(void *context, size_t index) = nullptr;
+    void *context = nullptr;
+    size_t index = 0;
+};
+
+// Work-stealing thread pool. Every worker owns a deque, it pushes and pops its own work at the back
+// and steals from the front of the other deques when it runs dry. Threads that are not workers submit
+// into a shared injection deque and can help execute tasks while they wait.
+class ThreadPool
+{
+public:
+    // threadCount is the number of worker threads, 0 uses one per hardware thread
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void Submit(const ThreadPoolTask &task);
+
+    // Executes and steals tasks on the calling thread until pending drops to zero
+    void WaitFor(const std::atomic<int> &pending);
+
+    // Runs function(context, i) for every i in [0, count) across the pool and the calling thread
+    void ParallelFor(size_t count, void (*function)(void *context, size_t index), void *context);
+
+    int getThreadCount() const { return static_cast<int>(m_Threads.size()); }
+
+private:
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;
+        std::deque<ThreadPoolTask> tasks;
+    };
+
+    void WorkerLoop(size_t index);
+    bool TryPop(size_t index, ThreadPoolTask &task);
+    bool TrySteal(size_t index, ThreadPoolTask &task);
+    size_t CurrentQueue() const;
+
+    std::vector<std::thread> m_Threads;
+    std::vector<std::unique_ptr<Queue>> m_Queues; // One per worker, the last one is the injection queue
+
+    std::atomic<int> m_QueuedCount{0};
+    std::atomic<bool> m_Stop{false};
+    std::mutex m_SleepMutex;
+    std::condition_variable m_WakeSignal;
+};
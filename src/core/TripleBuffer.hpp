@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single producer / single consumer triple buffer.
+// The producer writes into Back() and calls Publish(), the consumer calls Fetch() and reads Front().
+// Neither side ever waits on the other, the consumer always sees the most recently published value.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Producer side
+    T &Back() { return m_Buffers[m_BackIndex]; }
+
+    void Publish()
+    {
+        // Hand the back buffer over as the new middle buffer and take the old middle buffer as the next back buffer
+        uint8_t previous = m_Middle.exchange(static_cast<uint8_t>(m_BackIndex | FreshBit), std::memory_order_acq_rel);
+        m_BackIndex = previous & IndexMask;
+    }
+
+    // Consumer side, returns true if a newer value was fetched
+    bool Fetch()
+    {
+        if ((m_Middle.load(std::memory_order_relaxed) & FreshBit) == 0)
+        {
+            return false;
+        }
+
+        uint8_t previous = m_Middle.exchange(m_FrontIndex, std::memory_order_acq_rel);
+        m_FrontIndex = previous & IndexMask;
+        return true;
+    }
+
+    const T &Front() const { return m_Buffers[m_FrontIndex]; }
+
+private:
+    static constexpr uint8_t IndexMask = 0x3;
+    static constexpr uint8_t FreshBit = 0x4;
+
+    std::array<T, 3> m_Buffers{};
+    std::atomic<uint8_t> m_Middle{1};
+    uint8_t m_BackIndex = 0;  // Owned by the producer
+    uint8_t m_FrontIndex = 2; // Owned by the consumer
+};
@@ -0,0 +1,293 @@
+#include "Fft.hpp"
+
+#include "FftKernel.inl"
+#include "SinCos.hpp"
+
+#include "core/TableCache.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+namespace Dsp
+{
+#if defined(DMC_DSP_X86_DISPATCH)
+    void FftPassSse42(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm,
+                      const float *rootRe, const float *rootIm, int size, int radix, int stride);
+    void FftPassAvx2(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm,
+                     const float *rootRe, const float *rootIm, int size, int radix, int stride);
+    void FftPassAvx512(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm,
+                       const float *rootRe, const float *rootIm, int size, int radix, int stride);
+#endif
+}
+
+namespace
+{
+    using FftPassKernel = void (*)(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm,
+                                   const float *rootRe, const float *rootIm, int size, int radix, int stride);
+
+    // Indexed by Dsp::Isa, the instruction set is shared with the SinCos kernels
+    const FftPassKernel FftKernelTable[] = {
+        &KernelFftPass,
+#if defined(DMC_DSP_X86_DISPATCH)
+        &Dsp::FftPassSse42,
+        &Dsp::FftPassAvx2,
+        &Dsp::FftPassAvx512,
+#endif
+    };
+
+    constexpr double TwoPi = 6.283185307179586477;
+
+    // Working buffers of the transforms running on this thread, only ever grown
+    float *Scratch(size_t floats)
+    {
+        thread_local AlignedVector<float> scratch;
+        if (scratch.size() < floats)
+        {
+            scratch.resize(floats);
+        }
+        return scratch.data();
+    }
+}
+
+namespace Dsp
+{
+    std::shared_ptr<const FftPlan> FftPlan::Get(int size, FftDirection direction, FftLayout layout)
+    {
+        char key[64];
+        std::snprintf(key, sizeof(key), "fft.%d.%d.%d", size, static_cast<int>(direction), static_cast<int>(layout));
+        return TableCache::Shared().GetOrBuild<FftPlan>(key, [&]() { return FftPlan(size, direction, layout); });
+    }
+
+    FftPlan::FftPlan(int size, FftDirection direction, FftLayout layout) : m_Size(size), m_Direction(direction), m_Layout(layout)
+    {
+        if (size < 1)
+        {
+            throw std::invalid_argument("FftPlan needs a size of at least 1");
+        }
+
+        // Real transforms of even size run as a complex transform of half the size, odd ones at full size
+        m_PassSize = layout == FftLayout::Real && size % 2 == 0 ? size / 2 : size;
+
+        // Radix 4 first while it divides, then the rest of the factors from small to large
+        std::vector<int> radices;
+        int rest = m_PassSize;
+        while (rest % 4 == 0)
+        {
+            radices.push_back(4);
+            rest /= 4;
+        }
+        for (int factor = 2; rest > 1; factor++)
+        {
+            while (rest % factor == 0)
+            {
+                radices.push_back(factor);
+                rest /= factor;
+            }
+        }
+
+        int stride = 1;
+        for (int radix : radices)
+        {
+            Pass pass{radix, stride, m_TwiddleRe.size(), m_RootRe.size()};
+            for (int r = 1; r < radix; r++)
+            {
+                for (int k = 0; k < stride; k++)
+                {
+                    const double angle = -TwoPi * r * k / (static_cast<double>(stride) * radix);
+                    m_TwiddleRe.push_back(static_cast<float>(std::cos(angle)));
+                    m_TwiddleIm.push_back(static_cast<float>(std::sin(angle)));
+                }
+            }
+            if (radix > 5)
+            {
+                for (int q = 0; q < radix; q++)
+                {
+                    m_RootRe.push_back(static_cast<float>(std::cos(-TwoPi * q / radix)));
+                    m_RootIm.push_back(static_cast<float>(std::sin(-TwoPi * q / radix)));
+                }
+            }
+            m_Passes.push_back(pass);
+            stride *= radix;
+        }
+
+        if (layout == FftLayout::Real)
+        {
+            for (int k = 0; k <= size / 2; k++)
+            {
+                m_RealRe.push_back(static_cast<float>(std::cos(-TwoPi * k / size)));
+                m_RealIm.push_back(static_cast<float>(std::sin(-TwoPi * k / size)));
+            }
+        }
+    }
+
+    void FftPlan::RunPasses(float *&re, float *&im, float *&scratchRe, float *&scratchIm) const
+    {
+        const FftPassKernel kernel = FftKernelTable[static_cast<int>(getIsa())];
+        for (const Pass &pass : m_Passes)
+        {
+            kernel(re, im, scratchRe, scratchIm, m_TwiddleRe.data() + pass.twiddle, m_TwiddleIm.data() + pass.twiddle,
+                   m_RootRe.data() + pass.root, m_RootIm.data() + pass.root, m_PassSize, pass.radix, pass.stride);
+            std::swap(re, scratchRe);
+            std::swap(im, scratchIm);
+        }
+    }
+
+    void FftPlan::Execute(const std::complex<float> *in, std::complex<float> *out, int count) const
+    {
+        if (m_Layout != FftLayout::Complex)
+        {
+            throw std::logic_error("FftPlan: complex transform requested from a real plan");
+        }
+
+        // The inverse is the conjugate of the forward transform of the conjugate, folded into loading and storing
+        const float sign = m_Direction == FftDirection::Forward ? 1.0f : -1.0f;
+        const int n = m_Size;
+        float *buffer = Scratch(4 * static_cast<size_t>(n));
+        for (int t = 0; t < count; t++)
+        {
+            const float *source = reinterpret_cast<const float *>(in + static_cast<size_t>(t) * n);
+            float *re = buffer, *im = buffer + n, *scratchRe = buffer + 2 * n, *scratchIm = buffer + 3 * n;
+            for (int i = 0; i < n; i++)
+            {
+                re[i] = source[2 * i];
+                im[i] = sign * source[2 * i + 1];
+            }
+
+            RunPasses(re, im, scratchRe, scratchIm);
+
+            float *target = reinterpret_cast<float *>(out + static_cast<size_t>(t) * n);
+            for (int i = 0; i < n; i++)
+            {
+                target[2 * i] = re[i];
+                target[2 * i + 1] = sign * im[i];
+            }
+        }
+    }
+
+    void FftPlan::Execute(const float *in, std::complex<float> *out, int count) const
+    {
+        if (m_Layout != FftLayout::Real || m_Direction != FftDirection::Forward)
+        {
+            throw std::logic_error("FftPlan: real forward transform requested from another kind of plan");
+        }
+
+        const int n = m_Size;
+        const int half = m_PassSize;
+        const int bins = getBins();
+        float *buffer = Scratch(4 * static_cast<size_t>(half));
+        for (int t = 0; t < count; t++)
+        {
+            const float *source = in + static_cast<size_t>(t) * n;
+            float *target = reinterpret_cast<float *>(out + static_cast<size_t>(t) * bins);
+            float *re = buffer, *im = buffer + half, *scratchRe = buffer + 2 * half, *scratchIm = buffer + 3 * half;
+
+            if (n % 2 != 0)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    re[i] = source[i];
+                    im[i] = 0.0f;
+                }
+                RunPasses(re, im, scratchRe, scratchIm);
+                for (int k = 0; k < bins; k++)
+                {
+                    target[2 * k] = re[k];
+                    target[2 * k + 1] = im[k];
+                }
+                continue;
+            }
+
+            // Even samples as the real part and odd samples as the imaginary part of a half size transform Z
+            for (int i = 0; i < half; i++)
+            {
+                re[i] = source[2 * i];
+                im[i] = source[2 * i + 1];
+            }
+            RunPasses(re, im, scratchRe, scratchIm);
+
+            // X[k] = E[k] + e^(-j 2 PI k / n) O[k] with E = (Z[k] + Z*[half - k]) / 2 and O = (Z[k] - Z*[half - k]) / 2j
+            target[0] = re[0] + im[0];
+            target[1] = 0.0f;
+            target[2 * half] = re[0] - im[0];
+            target[2 * half + 1] = 0.0f;
+            for (int k = 1; k < half; k++)
+            {
+                const float ar = re[k], ai = im[k];
+                const float br = re[half - k], bi = -im[half - k];
+                const float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+                const float or_ = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+                const float wr = m_RealRe[k], wi = m_RealIm[k];
+                target[2 * k] = er + or_ * wr - oi * wi;
+                target[2 * k + 1] = ei + or_ * wi + oi * wr;
+            }
+        }
+    }
+
+    void FftPlan::Execute(const std::complex<float> *in, float *out, int count) const
+    {
+        if (m_Layout != FftLayout::Real || m_Direction != FftDirection::Inverse)
+        {
+            throw std::logic_error("FftPlan: real inverse transform requested from another kind of plan");
+        }
+
+        const int n = m_Size;
+        const int half = m_PassSize;
+        const int bins = getBins();
+        float *buffer = Scratch(4 * static_cast<size_t>(half));
+        for (int t = 0; t < count; t++)
+        {
+            const float *source = reinterpret_cast<const float *>(in + static_cast<size_t>(t) * bins);
+            float *target = out + static_cast<size_t>(t) * n;
+            float *re = buffer, *im = buffer + half, *scratchRe = buffer + 2 * half, *scratchIm = buffer + 3 * half;
+
+            // Inverse as the forward transform of the conjugate, the conjugate of the result is real
+            if (n % 2 != 0)
+            {
+                re[0] = source[0];
+                im[0] = 0.0f;
+                for (int k = 1; k < bins; k++)
+                {
+                    re[k] = source[2 * k];
+                    im[k] = -source[2 * k + 1];
+                    re[n - k] = source[2 * k];
+                    im[n - k] = source[2 * k + 1];
+                }
+                RunPasses(re, im, scratchRe, scratchIm);
+                for (int i = 0; i < n; i++)
+                {
+                    target[i] = re[i];
+                }
+                continue;
+            }
+
+            // Undoes the forward combination: Z[k] = (X[k] + X*[half - k]) + j e^(j 2 PI k / n) (X[k] - X*[half - k]),
+            // conjugated for the forward passes
+            {
+                const float ar = source[0], br = source[2 * half];
+                re[0] = ar + br;
+                im[0] = -(ar - br);
+            }
+            for (int k = 1; k < half; k++)
+            {
+                const float ar = source[2 * k], ai = source[2 * k + 1];
+                const float br = source[2 * (half - k)], bi = -source[2 * (half - k) + 1];
+                const float sr = ar + br, si = ai + bi;
+                const float dr = ar - br, di = ai - bi;
+                // j conj(w) d with w = m_Real[k]
+                const float wr = m_RealRe[k], wi = -m_RealIm[k];
+                const float pr = dr * wr - di * wi, pi = dr * wi + di * wr;
+                re[k] = sr - pi;
+                im[k] = -(si + pr);
+            }
+            RunPasses(re, im, scratchRe, scratchIm);
+
+            for (int i = 0; i < half; i++)
+            {
+                target[2 * i] = re[i];
+                target[2 * i + 1] = -im[i];
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "core/AlignedAllocator.hpp"
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+// Fast Fourier transforms for the block objects (pulse compression, Doppler processing, spectra).
+//
+// Any size is supported. Sizes are factored into radix 4, 2, 3 and 5 passes of a Stockham autosort FFT (no bit
+// reversal, output in natural order). Remaining prime factors use a direct DFT butterfly, so sizes with large
+// prime factors are slow. Like the other kernels the passes have one build per instruction set and follow
+// Dsp::getIsa(), they are built without multiply-add contraction so every instruction set gives the same bits.
+//
+// Transforms are unnormalized: X[k] = sum x[n] e^(-+j 2 PI k n / size), forward then inverse scales by size.
+namespace Dsp
+{
+    enum class FftDirection
+    {
+        Forward, // e^(-j ...)
+        Inverse, // e^(+j ...)
+    };
+
+    enum class FftLayout
+    {
+        Complex, // size complex points in, size complex points out
+        Real,    // size real points in the time domain, the size / 2 + 1 non-negative frequency bins in the other
+    };
+
+    // Precomputed factorization and twiddles of one transform. Plans never change once built, so one plan is
+    // shared by every object and thread that needs its size (see Get()). Working buffers are kept per thread and
+    // reused by every transform on that thread.
+    class FftPlan
+    {
+    public:
+        // Plan from the process-wide TableCache, built on first use
+        static std::shared_ptr<const FftPlan> Get(int size, FftDirection direction, FftLayout layout = FftLayout::Complex);
+
+        FftPlan(int size, FftDirection direction, FftLayout layout = FftLayout::Complex);
+
+        int getSize() const { return m_Size; }
+        FftDirection getDirection() const { return m_Direction; }
+        FftLayout getLayout() const { return m_Layout; }
+
+        // Points per transform in the frequency domain, size for complex and size / 2 + 1 for real plans
+        int getBins() const { return m_Layout == FftLayout::Complex ? m_Size : m_Size / 2 + 1; }
+
+        // Complex plans: count transforms stored back to back, out may be in (in place)
+        void Execute(const std::complex<float> *in, std::complex<float> *out, int count = 1) const;
+        void Execute(std::complex<float> *data, int count = 1) const { Execute(data, data, count); }
+
+        // Real forward plans: count transforms of size samples to getBins() bins each
+        void Execute(const float *in, std::complex<float> *out, int count = 1) const;
+
+        // Real inverse plans: count transforms of getBins() bins to size samples each. The imaginary parts of
+        // bin 0 (and of bin size / 2 for even sizes) are ignored, as for any real signal they are 0.
+        void Execute(const std::complex<float> *in, float *out, int count = 1) const;
+
+    private:
+        struct Pass
+        {
+            int radix;
+            int stride;
+            size_t twiddle; // First twiddle of the pass in m_TwiddleRe/m_TwiddleIm
+            size_t root;    // First root of a generic radix pass in m_RootRe/m_RootIm
+        };
+
+        // Forward complex transform of m_PassSize points in split format, ping-ponging between the data and the
+        // scratch buffers. re and im point to the result afterwards.
+        void RunPasses(float *&re, float *&im, float *&scratchRe, float *&scratchIm) const;
+
+        int m_Size;
+        FftDirection m_Direction;
+        FftLayout m_Layout;
+
+        // Points of the complex transform doing the work, size / 2 for real plans of even size
+        int m_PassSize;
+        std::vector<Pass> m_Passes;
+        AlignedVector<float> m_TwiddleRe;
+        AlignedVector<float> m_TwiddleIm;
+        AlignedVector<float> m_RootRe;
+        AlignedVector<float> m_RootIm;
+
+        // e^(-j 2 PI k / size) for k in [0, size / 2], combines the half size transform of real plans
+        AlignedVector<float> m_RealRe;
+        AlignedVector<float> m_RealIm;
+    };
+}
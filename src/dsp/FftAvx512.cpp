@@ -0,0 +1,15 @@
+// AVX-512 build of the FFT butterfly passes, compiled with AVX-512 target flags (see CMakeLists.txt)
+#if defined(DMC_DSP_X86_DISPATCH)
+
+#include "FftKernel.inl"
+
+namespace Dsp
+{
+    void FftPassAvx512(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm,
+                       const float *rootRe, const float *rootIm, int size, int radix, int stride)
+    {
+        KernelFftPass(inRe, inIm, outRe, outIm, twRe, twIm, rootRe, rootIm, size, radix, stride);
+    }
+}
+
+#endif
@@ -0,0 +1,287 @@
+// Body of the FFT butterfly passes, included by one translation unit per instruction set and compiled with that
+// unit's target flags. Everything is in an anonymous namespace so each copy keeps internal linkage. Data is in
+// split format (real and imaginary parts in separate arrays) and the butterflies are straight-line code on small
+// local arrays, so the compiler vectorizes the loops around them for the target.
+
+#include <cstddef>
+#include <cstdint>
+
+// The passes never write a buffer they read, the compiler can't prove that for this many streams
+#if defined(__clang__)
+#define DMC_FFT_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define DMC_FFT_IVDEP _Pragma("GCC ivdep")
+#else
+#define DMC_FFT_IVDEP
+#endif
+
+namespace
+{
+    constexpr float Sin60 = 0.866025403784438647f;
+    constexpr float Cos72 = 0.309016994374947424f;
+    constexpr float Sin72 = 0.951056516295153572f;
+    constexpr float Cos144 = -0.809016994374947424f;
+    constexpr float Sin144 = 0.587785252292473129f;
+
+    // Forward DFT of Radix points in place
+    template <int Radix>
+    inline void Butterfly(float (&re)[Radix], float (&im)[Radix])
+    {
+        if constexpr (Radix == 2)
+        {
+            const float r0 = re[0], i0 = im[0];
+            re[0] = r0 + re[1];
+            im[0] = i0 + im[1];
+            re[1] = r0 - re[1];
+            im[1] = i0 - im[1];
+        }
+        else if constexpr (Radix == 3)
+        {
+            const float sr = re[1] + re[2], si = im[1] + im[2];
+            const float dr = Sin60 * (re[1] - re[2]), di = Sin60 * (im[1] - im[2]);
+            const float mr = re[0] - 0.5f * sr, mi = im[0] - 0.5f * si;
+            re[0] += sr;
+            im[0] += si;
+            // -j sin(60) (x1 - x2)
+            re[1] = mr + di;
+            im[1] = mi - dr;
+            re[2] = mr - di;
+            im[2] = mi + dr;
+        }
+        else if constexpr (Radix == 4)
+        {
+            const float t0r = re[0] + re[2], t0i = im[0] + im[2];
+            const float t1r = re[0] - re[2], t1i = im[0] - im[2];
+            const float t2r = re[1] + re[3], t2i = im[1] + im[3];
+            // -j (x1 - x3)
+            const float t3r = im[1] - im[3], t3i = re[3] - re[1];
+            re[0] = t0r + t2r;
+            im[0] = t0i + t2i;
+            re[1] = t1r + t3r;
+            im[1] = t1i + t3i;
+            re[2] = t0r - t2r;
+            im[2] = t0i - t2i;
+            re[3] = t1r - t3r;
+            im[3] = t1i - t3i;
+        }
+        else if constexpr (Radix == 5)
+        {
+            const float s1r = re[1] + re[4], s1i = im[1] + im[4];
+            const float s2r = re[2] + re[3], s2i = im[2] + im[3];
+            const float d1r = re[1] - re[4], d1i = im[1] - im[4];
+            const float d2r = re[2] - re[3], d2i = im[2] - im[3];
+
+            const float a1r = re[0] + Cos72 * s1r + Cos144 * s2r, a1i = im[0] + Cos72 * s1i + Cos144 * s2i;
+            const float a2r = re[0] + Cos144 * s1r + Cos72 * s2r, a2i = im[0] + Cos144 * s1i + Cos72 * s2i;
+            const float b1r = Sin72 * d1r + Sin144 * d2r, b1i = Sin72 * d1i + Sin144 * d2i;
+            const float b2r = Sin144 * d1r - Sin72 * d2r, b2i = Sin144 * d1i - Sin72 * d2i;
+
+            re[0] += s1r + s2r;
+            im[0] += s1i + s2i;
+            // a -+ j b
+            re[1] = a1r + b1i;
+            im[1] = a1i - b1r;
+            re[4] = a1r - b1i;
+            im[4] = a1i + b1r;
+            re[2] = a2r + b2i;
+            im[2] = a2i - b2r;
+            re[3] = a2r - b2i;
+            im[3] = a2i + b2r;
+        }
+    }
+
+    // Passes with at least this many consecutive butterflies per block run along the block in the inner loop
+    constexpr int FftContiguousMin = 16;
+
+    // Early pass with a small stride known at compile time, the butterflies of one block are unrolled and the loop
+    // over the blocks vectorizes with interleaving loads and stores
+    template <int Radix, int Stride>
+    void ShortPass(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm, int size)
+    {
+        const int quarter = size / Radix;
+        const int blocks = quarter / Stride;
+
+        float wr[Radix][Stride], wi[Radix][Stride];
+        for (int r = 1; r < Radix; r++)
+        {
+            for (int k = 0; k < Stride; k++)
+            {
+                wr[r][k] = twRe[(r - 1) * Stride + k];
+                wi[r][k] = twIm[(r - 1) * Stride + k];
+            }
+        }
+
+        DMC_FFT_IVDEP
+        for (int b = 0; b < blocks; b++)
+        {
+            DMC_FFT_IVDEP
+            for (int k = 0; k < Stride; k++)
+            {
+                const size_t in = static_cast<size_t>(b) * Stride + k;
+                const size_t out = static_cast<size_t>(b) * Stride * Radix + k;
+                float xr[Radix], xi[Radix];
+                xr[0] = inRe[in];
+                xi[0] = inIm[in];
+                for (int r = 1; r < Radix; r++)
+                {
+                    const float ar = inRe[in + static_cast<size_t>(r) * quarter], ai = inIm[in + static_cast<size_t>(r) * quarter];
+                    xr[r] = ar * wr[r][k] - ai * wi[r][k];
+                    xi[r] = ar * wi[r][k] + ai * wr[r][k];
+                }
+                Butterfly<Radix>(xr, xi);
+                for (int r = 0; r < Radix; r++)
+                {
+                    outRe[out + r * Stride] = xr[r];
+                    outIm[out + r * Stride] = xi[r];
+                }
+            }
+        }
+    }
+
+    // One decimation in time Stockham pass: the size / (Radix * stride) blocks each combine Radix transforms of
+    // stride points into one of Radix * stride points. Butterfly k of block b reads element b * stride + k of the
+    // Radix input quarters (thirds, ...) and writes elements k + r * stride of output block b, so the output is in
+    // natural order after the last pass without any reordering. twRe/twIm hold e^(-j 2 PI r k / (Radix stride))
+    // at [(r - 1) * stride + k].
+    template <int Radix>
+    void RadixPass(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm, int size, int stride)
+    {
+        const int quarter = size / Radix;
+        const int blocks = quarter / stride;
+
+        if (stride >= FftContiguousMin)
+        {
+            for (int b = 0; b < blocks; b++)
+            {
+                const float *blockRe = inRe + static_cast<size_t>(b) * stride;
+                const float *blockIm = inIm + static_cast<size_t>(b) * stride;
+                float *blockOutRe = outRe + static_cast<size_t>(b) * stride * Radix;
+                float *blockOutIm = outIm + static_cast<size_t>(b) * stride * Radix;
+                DMC_FFT_IVDEP
+                for (int k = 0; k < stride; k++)
+                {
+                    float xr[Radix], xi[Radix];
+                    xr[0] = blockRe[k];
+                    xi[0] = blockIm[k];
+                    for (int r = 1; r < Radix; r++)
+                    {
+                        const float ar = blockRe[k + r * quarter], ai = blockIm[k + r * quarter];
+                        const float br = twRe[(r - 1) * stride + k], bi = twIm[(r - 1) * stride + k];
+                        xr[r] = ar * br - ai * bi;
+                        xi[r] = ar * bi + ai * br;
+                    }
+                    Butterfly<Radix>(xr, xi);
+                    for (int r = 0; r < Radix; r++)
+                    {
+                        blockOutRe[k + r * stride] = xr[r];
+                        blockOutIm[k + r * stride] = xi[r];
+                    }
+                }
+            }
+            return;
+        }
+
+        switch (stride)
+        {
+        case 1:
+            ShortPass<Radix, 1>(inRe, inIm, outRe, outIm, twRe, twIm, size);
+            return;
+        case 2:
+            ShortPass<Radix, 2>(inRe, inIm, outRe, outIm, twRe, twIm, size);
+            return;
+        case 4:
+            ShortPass<Radix, 4>(inRe, inIm, outRe, outIm, twRe, twIm, size);
+            return;
+        case 8:
+            ShortPass<Radix, 8>(inRe, inIm, outRe, outIm, twRe, twIm, size);
+            return;
+        }
+
+        // Any other early pass, the same butterfly of all blocks in the inner loop with its twiddles held fixed
+        for (int k = 0; k < stride; k++)
+        {
+            float wr[Radix], wi[Radix];
+            for (int r = 1; r < Radix; r++)
+            {
+                wr[r] = twRe[(r - 1) * stride + k];
+                wi[r] = twIm[(r - 1) * stride + k];
+            }
+
+            DMC_FFT_IVDEP
+            for (int b = 0; b < blocks; b++)
+            {
+                const size_t in = static_cast<size_t>(b) * stride + k;
+                const size_t out = static_cast<size_t>(b) * stride * Radix + k;
+                float xr[Radix], xi[Radix];
+                xr[0] = inRe[in];
+                xi[0] = inIm[in];
+                for (int r = 1; r < Radix; r++)
+                {
+                    const float ar = inRe[in + static_cast<size_t>(r) * quarter], ai = inIm[in + static_cast<size_t>(r) * quarter];
+                    xr[r] = ar * wr[r] - ai * wi[r];
+                    xi[r] = ar * wi[r] + ai * wr[r];
+                }
+                Butterfly<Radix>(xr, xi);
+                for (int r = 0; r < Radix; r++)
+                {
+                    outRe[out + static_cast<size_t>(r) * stride] = xr[r];
+                    outIm[out + static_cast<size_t>(r) * stride] = xi[r];
+                }
+            }
+        }
+    }
+
+    // Any other radix, a direct DFT per butterfly with the roots e^(-j 2 PI q / radix) in rootRe/rootIm
+    void GenericPass(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm,
+                     const float *rootRe, const float *rootIm, int size, int radix, int stride)
+    {
+        const int quarter = size / radix;
+        const int blocks = quarter / stride;
+        for (int b = 0; b < blocks; b++)
+        {
+            for (int k = 0; k < stride; k++)
+            {
+                const size_t in = static_cast<size_t>(b) * stride + k;
+                const size_t out = static_cast<size_t>(b) * stride * radix + k;
+                for (int q = 0; q < radix; q++)
+                {
+                    float sumRe = inRe[in], sumIm = inIm[in];
+                    for (int r = 1; r < radix; r++)
+                    {
+                        const float xr = inRe[in + static_cast<size_t>(r) * quarter], xi = inIm[in + static_cast<size_t>(r) * quarter];
+                        const float wr = twRe[(r - 1) * stride + k], wi = twIm[(r - 1) * stride + k];
+                        const float tr = xr * wr - xi * wi, ti = xr * wi + xi * wr;
+                        const int root = static_cast<int>((static_cast<int64_t>(q) * r) % radix);
+                        sumRe += tr * rootRe[root] - ti * rootIm[root];
+                        sumIm += tr * rootIm[root] + ti * rootRe[root];
+                    }
+                    outRe[out + static_cast<size_t>(q) * stride] = sumRe;
+                    outIm[out + static_cast<size_t>(q) * stride] = sumIm;
+                }
+            }
+        }
+    }
+
+    void KernelFftPass(const float *inRe, const float *inIm, float *outRe, float *outIm, const float *twRe, const float *twIm,
+                       const float *rootRe, const float *rootIm, int size, int radix, int stride)
+    {
+        switch (radix)
+        {
+        case 2:
+            RadixPass<2>(inRe, inIm, outRe, outIm, twRe, twIm, size, stride);
+            break;
+        case 3:
+            RadixPass<3>(inRe, inIm, outRe, outIm, twRe, twIm, size, stride);
+            break;
+        case 4:
+            RadixPass<4>(inRe, inIm, outRe, outIm, twRe, twIm, size, stride);
+            break;
+        case 5:
+            RadixPass<5>(inRe, inIm, outRe, outIm, twRe, twIm, size, stride);
+            break;
+        default:
+            GenericPass(inRe, inIm, outRe, outIm, twRe, twIm, rootRe, rootIm, size, radix, stride);
+            break;
+        }
+    }
+}
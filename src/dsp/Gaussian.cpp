@@ -0,0 +1,36 @@
+#include "Gaussian.hpp"
+
+#include "GaussianKernel.inl"
+#include "SinCos.hpp"
+
+namespace Dsp
+{
+#if defined(DMC_DSP_X86_DISPATCH)
+    void PhiloxGaussianSse42(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out, int blockCount);
+    void PhiloxGaussianAvx2(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out, int blockCount);
+    void PhiloxGaussianAvx512(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out, int blockCount);
+#endif
+}
+
+namespace
+{
+    using PhiloxGaussianKernel = void (*)(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out, int blockCount);
+
+    // Indexed by Dsp::Isa, the instruction set is shared with the SinCos kernels
+    const PhiloxGaussianKernel GaussianKernelTable[] = {
+        &KernelPhiloxGaussian,
+#if defined(DMC_DSP_X86_DISPATCH)
+        &Dsp::PhiloxGaussianSse42,
+        &Dsp::PhiloxGaussianAvx2,
+        &Dsp::PhiloxGaussianAvx512,
+#endif
+    };
+}
+
+namespace Dsp
+{
+    void PhiloxGaussian(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out, int blockCount)
+    {
+        GaussianKernelTable[static_cast<int>(getIsa())](key, streamId, firstBlock, out, blockCount);
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// Block Gaussian noise kernels. Philox4x32-10 (see core/Random.hpp) and a Box-Muller transform evaluated for many
+// counter blocks side by side, one implementation per instruction set like the SinCos kernels.
+//
+// Accuracy: the logarithm and the sine/cosine are float polynomials with max abs error around 1e-7. The kernels are
+// built without multiply-add contraction, so the values are a pure function of (key, stream id, counter block) and
+// the same bits on every instruction set.
+namespace Dsp
+{
+    // Four standard normal values per counter block firstBlock, firstBlock + 1, ... of the stream. Values 2m and
+    // 2m + 1 are the cos and sin outputs of one Box-Muller transform of words 2m (radius) and 2m + 1 (angle), so
+    // each pair is also a complex normal value with unit variance per component.
+    void PhiloxGaussian(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out, int blockCount);
+}
@@ -0,0 +1,14 @@
+// AVX2 build of the Gaussian noise kernels, compiled with AVX2 target flags (see CMakeLists.txt)
+#if defined(DMC_DSP_X86_DISPATCH)
+
+#include "GaussianKernel.inl"
+
+namespace Dsp
+{
+    void PhiloxGaussianAvx2(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out, int blockCount)
+    {
+        KernelPhiloxGaussian(key, streamId, firstBlock, out, blockCount);
+    }
+}
+
+#endif
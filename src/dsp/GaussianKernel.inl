@@ -0,0 +1,135 @@
+// Body of the Gaussian noise kernels, included by one translation unit per instruction set and compiled with that
+// unit's target flags (see SinCosKernel.inl). The generator runs on GaussianLanes counter blocks at once stored as
+// structure of arrays, so every step is a plain loop over the lanes that the compiler vectorizes.
+
+#include "SinCosKernel.inl"
+
+#include "core/Random.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+    constexpr int GaussianLanes = 32;
+
+    // Natural logarithm of a positive normal float (Cephes logf), the mantissa is brought into [sqrt(1/2), sqrt(2))
+    // with bit operations so the loop stays branch free
+    inline float LogPositive(float x)
+    {
+        constexpr float Sqrt2 = 1.41421356237f;
+        constexpr float Ln2High = 0.693359375f;
+        constexpr float Ln2Low = -2.12194440e-4f;
+
+        const uint32_t bits = std::bit_cast<uint32_t>(x);
+        const uint32_t mantissaBits = (bits & 0x007FFFFFu) | 0x3F800000u;
+        const uint32_t halve = 0u - static_cast<uint32_t>(std::bit_cast<float>(mantissaBits) > Sqrt2);
+        const float mantissa = std::bit_cast<float>(mantissaBits - (halve & 0x00800000u));
+        const float exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127 + static_cast<int32_t>(halve & 1u));
+
+        const float f = mantissa - 1.0f;
+        const float f2 = f * f;
+        float p = 7.0376836292e-2f;
+        p = p * f - 1.1514610310e-1f;
+        p = p * f + 1.1676998740e-1f;
+        p = p * f - 1.2420140846e-1f;
+        p = p * f + 1.4249322787e-1f;
+        p = p * f - 1.6668057665e-1f;
+        p = p * f + 2.0000714765e-1f;
+        p = p * f - 2.4999993993e-1f;
+        p = p * f + 3.3333331174e-1f;
+        return f + (f * f2 * p + Ln2Low * exponent - 0.5f * f2) + Ln2High * exponent;
+    }
+
+    // Philox4x32-10 of GaussianLanes consecutive counter blocks, word w of lane l ends up in words[w][l]. The high
+    // and low halves of the products are separate expressions so they map onto vector multiplies.
+    inline void PhiloxLanes(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, uint32_t words[4][GaussianLanes])
+    {
+        constexpr uint32_t M0 = 0xD2511F53u;
+        constexpr uint32_t M1 = 0xCD9E8D57u;
+
+        uint32_t *c0 = words[0];
+        uint32_t *c1 = words[1];
+        uint32_t *c2 = words[2];
+        uint32_t *c3 = words[3];
+        for (int l = 0; l < GaussianLanes; l++)
+        {
+            const uint64_t block = firstBlock + l;
+            c0[l] = static_cast<uint32_t>(block);
+            c1[l] = static_cast<uint32_t>(block >> 32);
+            c2[l] = streamId[0];
+            c3[l] = streamId[1];
+        }
+
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+        for (int round = 0; round < 10; round++)
+        {
+            for (int l = 0; l < GaussianLanes; l++)
+            {
+                const uint32_t high0 = static_cast<uint32_t>((static_cast<uint64_t>(c0[l]) * M0) >> 32);
+                const uint32_t high1 = static_cast<uint32_t>((static_cast<uint64_t>(c2[l]) * M1) >> 32);
+                const uint32_t low0 = c0[l] * M0;
+                const uint32_t low1 = c2[l] * M1;
+                c0[l] = high1 ^ c1[l] ^ k0;
+                c2[l] = high0 ^ c3[l] ^ k1;
+                c1[l] = low1;
+                c3[l] = low0;
+            }
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+    }
+
+    // Box-Muller of GaussianLanes counter blocks, the angle word is used directly as a 32 bit fixed point phase
+    inline void GaussianLanesBlock(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out)
+    {
+        constexpr float PhaseScale = static_cast<float>(1.5707963267948966 / 1073741824.0); // PI / 2 per 2^30
+
+        uint32_t words[4][GaussianLanes];
+        PhiloxLanes(key, streamId, firstBlock, words);
+
+        float radius[2][GaussianLanes];
+        float sine[2][GaussianLanes];
+        float cosine[2][GaussianLanes];
+        for (int pair = 0; pair < 2; pair++)
+        {
+            for (int l = 0; l < GaussianLanes; l++)
+            {
+                radius[pair][l] = std::sqrt(-2.0f * LogPositive(Random::ToUniform(words[2 * pair][l])));
+
+                // ReducePhase() on a 32 bit phase, kept in 32 bit lanes
+                const uint32_t shifted = words[2 * pair + 1][l] + (1u << 29);
+                const int32_t residual = static_cast<int32_t>(shifted & ((1u << 30) - 1)) - (1 << 29);
+                SinCosQuadrant(shifted >> 30, static_cast<float>(residual) * PhaseScale, sine[pair][l], cosine[pair][l]);
+            }
+        }
+
+        for (int l = 0; l < GaussianLanes; l++)
+        {
+            out[4 * l] = radius[0][l] * cosine[0][l];
+            out[4 * l + 1] = radius[0][l] * sine[0][l];
+            out[4 * l + 2] = radius[1][l] * cosine[1][l];
+            out[4 * l + 3] = radius[1][l] * sine[1][l];
+        }
+    }
+
+    void KernelPhiloxGaussian(const uint32_t key[2], const uint32_t streamId[2], uint64_t firstBlock, float *out, int blockCount)
+    {
+        for (; blockCount >= GaussianLanes; blockCount -= GaussianLanes)
+        {
+            GaussianLanesBlock(key, streamId, firstBlock, out);
+            firstBlock += GaussianLanes;
+            out += 4 * GaussianLanes;
+        }
+
+        if (blockCount > 0)
+        {
+            float values[4 * GaussianLanes];
+            GaussianLanesBlock(key, streamId, firstBlock, values);
+            std::copy(values, values + 4 * blockCount, out);
+        }
+    }
+}
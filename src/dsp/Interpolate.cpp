@@ -0,0 +1,36 @@
+#include "Interpolate.hpp"
+
+#include "InterpolateKernel.inl"
+#include "SinCos.hpp"
+
+namespace Dsp
+{
+#if defined(DMC_DSP_X86_DISPATCH)
+    void InterpolateUniformSse42(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count);
+    void InterpolateUniformAvx2(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count);
+    void InterpolateUniformAvx512(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count);
+#endif
+}
+
+namespace
+{
+    using InterpolateKernel = void (*)(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count);
+
+    // Indexed by Dsp::Isa, the instruction set is shared with the SinCos kernels
+    const InterpolateKernel InterpolateKernelTable[] = {
+        &KernelInterpolateUniform,
+#if defined(DMC_DSP_X86_DISPATCH)
+        &Dsp::InterpolateUniformSse42,
+        &Dsp::InterpolateUniformAvx2,
+        &Dsp::InterpolateUniformAvx512,
+#endif
+    };
+}
+
+namespace Dsp
+{
+    void InterpolateUniform(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count)
+    {
+        InterpolateKernelTable[static_cast<int>(getIsa())](table, size, xMin, xScale, x, stride, out, count);
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Block linear interpolation in tables sampled on a uniform grid (discriminator curves, calibrations). The lookups
+// are gathers, so like the other kernels there is one build per instruction set following Dsp::getIsa(), and the
+// results are the same bits on every one of them.
+namespace Dsp
+{
+    // out[n] = table interpolated at position (x[n * stride] - xMin) * xScale, positions are clamped to
+    // [0, size - 1] so values outside the table give its end points and NaN gives table[0]. size must be at least 2.
+    void InterpolateUniform(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count);
+}
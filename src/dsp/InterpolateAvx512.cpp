@@ -0,0 +1,14 @@
+// AVX-512 build of the table interpolation kernels, compiled with AVX-512 target flags (see CMakeLists.txt)
+#if defined(DMC_DSP_X86_DISPATCH)
+
+#include "InterpolateKernel.inl"
+
+namespace Dsp
+{
+    void InterpolateUniformAvx512(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count)
+    {
+        KernelInterpolateUniform(table, size, xMin, xScale, x, stride, out, count);
+    }
+}
+
+#endif
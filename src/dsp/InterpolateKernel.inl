@@ -0,0 +1,52 @@
+// Body of the table interpolation kernels, included by one translation unit per instruction set and compiled with
+// that unit's target flags. Everything is in an anonymous namespace so each copy keeps internal linkage. The loop
+// is branch free, the table reads vectorize as gathers on targets that have them.
+
+#include <algorithm>
+
+// The output never overlaps the table or the positions, the compiler can't prove that for the gathered reads
+#if defined(__clang__)
+#define DMC_INTERPOLATE_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define DMC_INTERPOLATE_IVDEP _Pragma("GCC ivdep")
+#else
+#define DMC_INTERPOLATE_IVDEP
+#endif
+
+namespace
+{
+    template <int Stride>
+    void InterpolateLoop(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count)
+    {
+        // A stride known at compile time keeps the loads of x contiguous or interleaved instead of gathered
+        const int step = Stride > 0 ? Stride : stride;
+        const float last = static_cast<float>(size - 1);
+        DMC_INTERPOLATE_IVDEP
+        for (int n = 0; n < count; n++)
+        {
+            // A NaN position fails the first comparison and ends up at 0
+            const float unclamped = (x[n * step] - xMin) * xScale;
+            const float low = unclamped > 0.0f ? unclamped : 0.0f;
+            const float position = low < last ? low : last;
+            const int i = std::min(static_cast<int>(position), size - 2);
+            const float f = position - static_cast<float>(i);
+            out[n] = table[i] + f * (table[i + 1] - table[i]);
+        }
+    }
+
+    void KernelInterpolateUniform(const float *table, int size, float xMin, float xScale, const float *x, int stride, float *out, int count)
+    {
+        switch (stride)
+        {
+        case 1:
+            InterpolateLoop<1>(table, size, xMin, xScale, x, stride, out, count);
+            break;
+        case 2:
+            InterpolateLoop<2>(table, size, xMin, xScale, x, stride, out, count);
+            break;
+        default:
+            InterpolateLoop<0>(table, size, xMin, xScale, x, stride, out, count);
+            break;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include "Monopulse.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+#if defined(__SSE2__)
+    // [x0, x1, x2, x3] -> [x1, x0, x3, x2], swaps the real and imaginary parts of two complex values
+    inline __m128 SwapPairs(__m128 x)
+    {
+        return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    // delta * conj(sum) * reciprocal for two complex values, the reciprocal is repeated for both parts
+    inline __m128 ScaledProduct(__m128 delta, __m128 sum, __m128 reciprocal)
+    {
+        // Re = dr sr + di si, Im = di sr - dr si
+        const __m128 direct = _mm_mul_ps(delta, sum);
+        const __m128 crossed = _mm_mul_ps(delta, SwapPairs(sum));
+        const __m128 real = _mm_add_ps(direct, SwapPairs(direct));      // [Re0, Re0, Re1, Re1]
+        const __m128 imaginary = _mm_sub_ps(SwapPairs(crossed), crossed); // [Im0, -Im0, Im1, -Im1]
+        const __m128 packed = _mm_shuffle_ps(real, imaginary, _MM_SHUFFLE(2, 0, 2, 0)); // [Re0, Re1, Im0, Im1]
+        return _mm_mul_ps(_mm_shuffle_ps(packed, packed, _MM_SHUFFLE(3, 1, 2, 0)), reciprocal);
+    }
+#endif
+}
+
+namespace Dsp
+{
+    void MonopulseButterfly(const std::complex<float> *horns, std::complex<float> *sum, std::complex<float> *azimuth,
+                            std::complex<float> *elevation, std::complex<float> *quadrature, int count)
+    {
+        const float *in = reinterpret_cast<const float *>(horns);
+        float *s = reinterpret_cast<float *>(sum);
+        float *az = reinterpret_cast<float *>(azimuth);
+        float *el = reinterpret_cast<float *>(elevation);
+        float *q = reinterpret_cast<float *>(quadrature);
+        int i = 0;
+
+#if defined(__SSE2__)
+        // One register holds [A, B] and one [C, D] of a sample. [A, B] +- [C, D] gives [A + C, B + D] and
+        // [A - C, B - D], two samples' halves are then regrouped so the second butterfly writes two complex
+        // results per store.
+        for (; i + 2 <= count; i += 2)
+        {
+            const __m128 ab0 = _mm_loadu_ps(in + 8 * i);
+            const __m128 cd0 = _mm_loadu_ps(in + 8 * i + 4);
+            const __m128 ab1 = _mm_loadu_ps(in + 8 * i + 8);
+            const __m128 cd1 = _mm_loadu_ps(in + 8 * i + 12);
+
+            const __m128 upper0 = _mm_add_ps(ab0, cd0);
+            const __m128 lower0 = _mm_sub_ps(ab0, cd0);
+            const __m128 upper1 = _mm_add_ps(ab1, cd1);
+            const __m128 lower1 = _mm_sub_ps(ab1, cd1);
+
+            const __m128 ac = _mm_movelh_ps(upper0, upper1);     // A + C of both samples
+            const __m128 bd = _mm_movehl_ps(upper1, upper0);     // B + D
+            const __m128 aMinusC = _mm_movelh_ps(lower0, lower1); // A - C
+            const __m128 bMinusD = _mm_movehl_ps(lower1, lower0); // B - D
+
+            _mm_storeu_ps(s + 2 * i, _mm_add_ps(ac, bd));
+            _mm_storeu_ps(az + 2 * i, _mm_sub_ps(ac, bd));
+            _mm_storeu_ps(el + 2 * i, _mm_add_ps(aMinusC, bMinusD));
+            _mm_storeu_ps(q + 2 * i, _mm_sub_ps(aMinusC, bMinusD));
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            const float *h = in + 8 * i;
+            for (int k = 0; k < 2; k++)
+            {
+                const float ac = h[k] + h[4 + k];
+                const float bd = h[2 + k] + h[6 + k];
+                const float aMinusC = h[k] - h[4 + k];
+                const float bMinusD = h[2 + k] - h[6 + k];
+                s[2 * i + k] = ac + bd;
+                az[2 * i + k] = ac - bd;
+                el[2 * i + k] = aMinusC + bMinusD;
+                q[2 * i + k] = aMinusC - bMinusD;
+            }
+        }
+    }
+
+    void MonopulseRatio(const std::complex<float> *sum, const std::complex<float> *delta0, const std::complex<float> *delta1,
+                        std::complex<float> *ratio0, std::complex<float> *ratio1, int count)
+    {
+        const float *s = reinterpret_cast<const float *>(sum);
+        const float *d0 = reinterpret_cast<const float *>(delta0);
+        const float *d1 = reinterpret_cast<const float *>(delta1);
+        float *r0 = reinterpret_cast<float *>(ratio0);
+        float *r1 = reinterpret_cast<float *>(ratio1);
+        int i = 0;
+
+#if defined(__SSE2__)
+        // Two cells per register. |sum|^2 is floored at FLT_MIN so a zero sum gives a finite reciprocal times a
+        // zero product instead of a NaN.
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 smallest = _mm_set1_ps(FLT_MIN);
+        for (; i + 2 <= count; i += 2)
+        {
+            const __m128 sumValue = _mm_loadu_ps(s + 2 * i);
+            const __m128 squares = _mm_mul_ps(sumValue, sumValue);
+            const __m128 power = _mm_max_ps(_mm_add_ps(squares, SwapPairs(squares)), smallest);
+
+            // r' = r (2 - p r) doubles the 12 correct bits of rcpps
+            const __m128 estimate = _mm_rcp_ps(power);
+            const __m128 reciprocal = _mm_mul_ps(estimate, _mm_sub_ps(two, _mm_mul_ps(power, estimate)));
+
+            _mm_storeu_ps(r0 + 2 * i, ScaledProduct(_mm_loadu_ps(d0 + 2 * i), sumValue, reciprocal));
+            _mm_storeu_ps(r1 + 2 * i, ScaledProduct(_mm_loadu_ps(d1 + 2 * i), sumValue, reciprocal));
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            const float sr = s[2 * i];
+            const float si = s[2 * i + 1];
+            const float reciprocal = 1.0f / std::max(sr * sr + si * si, FLT_MIN);
+            r0[2 * i] = (d0[2 * i] * sr + d0[2 * i + 1] * si) * reciprocal;
+            r0[2 * i + 1] = (d0[2 * i + 1] * sr - d0[2 * i] * si) * reciprocal;
+            r1[2 * i] = (d1[2 * i] * sr + d1[2 * i + 1] * si) * reciprocal;
+            r1[2 * i + 1] = (d1[2 * i + 1] * sr - d1[2 * i] * si) * reciprocal;
+        }
+    }
+}
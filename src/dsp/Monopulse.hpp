@@ -0,0 +1,18 @@
+#pragma once
+
+#include <complex>
+
+// Block kernels of the monopulse processing chain (see radar/MonopulseComparatorObject)
+namespace Dsp
+{
+    // Sum and difference channels of count samples of four frame-interleaved horn channels A, B, C, D:
+    // sum = A + B + C + D, azimuth = (A + C) - (B + D), elevation = (A + B) - (C + D), quadrature = (A + D) - (B + C)
+    void MonopulseButterfly(const std::complex<float> *horns, std::complex<float> *sum, std::complex<float> *azimuth,
+                            std::complex<float> *elevation, std::complex<float> *quadrature, int count);
+
+    // Normalized monopulse ratios delta * conj(sum) / |sum|^2 of two difference channels against one sum channel,
+    // the real part is the in-phase ratio and the imaginary part the quadrature ratio. The reciprocal of |sum|^2
+    // is an approximation refined with one Newton step (relative error around 1e-7), cells with a zero sum give 0.
+    void MonopulseRatio(const std::complex<float> *sum, const std::complex<float> *delta0, const std::complex<float> *delta1,
+                        std::complex<float> *ratio0, std::complex<float> *ratio1, int count);
+}
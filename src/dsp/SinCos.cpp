@@ -0,0 +1,115 @@
+#include "SinCos.hpp"
+
+#include "SinCosKernel.inl"
+
+#include <atomic>
+
+namespace Dsp
+{
+#if defined(DMC_DSP_X86_DISPATCH)
+    void SinCosSse42(uint64_t phase, uint64_t increment, float *sin, float *cos, int count);
+    void SinSse42(uint64_t phase, uint64_t increment, float *sin, int count);
+    void SinCosRadiansSse42(const float *radians, float *sin, float *cos, int count);
+    void SinCosAvx2(uint64_t phase, uint64_t increment, float *sin, float *cos, int count);
+    void SinAvx2(uint64_t phase, uint64_t increment, float *sin, int count);
+    void SinCosRadiansAvx2(const float *radians, float *sin, float *cos, int count);
+    void SinCosAvx512(uint64_t phase, uint64_t increment, float *sin, float *cos, int count);
+    void SinAvx512(uint64_t phase, uint64_t increment, float *sin, int count);
+    void SinCosRadiansAvx512(const float *radians, float *sin, float *cos, int count);
+#endif
+}
+
+namespace
+{
+    struct Kernels
+    {
+        void (*sinCos)(uint64_t phase, uint64_t increment, float *sin, float *cos, int count);
+        void (*sin)(uint64_t phase, uint64_t increment, float *sin, int count);
+        void (*sinCosRadians)(const float *radians, float *sin, float *cos, int count);
+    };
+
+    const Kernels KernelTable[] = {
+        {&KernelSinCosPhase, &KernelSinPhase, &KernelSinCosRadians},
+#if defined(DMC_DSP_X86_DISPATCH)
+        {&Dsp::SinCosSse42, &Dsp::SinSse42, &Dsp::SinCosRadiansSse42},
+        {&Dsp::SinCosAvx2, &Dsp::SinAvx2, &Dsp::SinCosRadiansAvx2},
+        {&Dsp::SinCosAvx512, &Dsp::SinAvx512, &Dsp::SinCosRadiansAvx512},
+#endif
+    };
+
+    std::atomic<int> &CurrentIsa()
+    {
+        static std::atomic<int> isa{static_cast<int>(Dsp::DetectIsa())};
+        return isa;
+    }
+
+    const Kernels &Current()
+    {
+        return KernelTable[CurrentIsa().load(std::memory_order_relaxed)];
+    }
+}
+
+namespace Dsp
+{
+    Isa DetectIsa()
+    {
+#if defined(DMC_DSP_X86_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+        {
+            return Isa::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return Isa::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.2"))
+        {
+            return Isa::Sse42;
+        }
+#endif
+        return Isa::Generic;
+    }
+
+    Isa getIsa()
+    {
+        return static_cast<Isa>(CurrentIsa().load(std::memory_order_relaxed));
+    }
+
+    void setIsa(Isa isa)
+    {
+        const int supported = static_cast<int>(DetectIsa());
+        CurrentIsa().store(static_cast<int>(isa) < supported ? static_cast<int>(isa) : supported, std::memory_order_relaxed);
+    }
+
+    const char *IsaName(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::Generic:
+            return "generic";
+        case Isa::Sse42:
+            return "SSE4.2";
+        case Isa::Avx2:
+            return "AVX2";
+        case Isa::Avx512:
+            return "AVX-512";
+        }
+        return "unknown";
+    }
+
+    void SinCos(uint64_t phase, uint64_t increment, float *sin, float *cos, int count)
+    {
+        Current().sinCos(phase, increment, sin, cos, count);
+    }
+
+    void Sin(uint64_t phase, uint64_t increment, float *sin, int count)
+    {
+        Current().sin(phase, increment, sin, count);
+    }
+
+    void SinCos(const float *radians, float *sin, float *cos, int count)
+    {
+        Current().sinCosRadians(radians, sin, cos, count);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// Block sine/cosine kernels. Every function has one implementation per instruction set (generic, SSE4.2, AVX2,
+// AVX-512), the best one the CPU supports is picked at first use.
+//
+// The kernels are built without multiply-add contraction, so every instruction set gives the same bits.
+//
+// Accuracy (float results, measured against double precision libm, the same on every instruction set):
+//   Phase kernels:   max abs error 1.2e-7 for any phase, the quadrant is taken exactly from the fixed point phase.
+//   Radians kernels: max abs error 9.2e-8 for |x| <= 1e4 rad, growing about linearly with |x| beyond that (9.6e-7
+//                    at 1e5) as the range reduction runs in float. Carriers should use the phase kernels.
+namespace Dsp
+{
+    enum class Isa
+    {
+        Generic, // Portable C++, vectorized by the compiler for the baseline target
+        Sse42,
+        Avx2,
+        Avx512,
+    };
+
+    // Best instruction set of the running CPU that the kernels were built for
+    Isa DetectIsa();
+
+    // Instruction set the kernels currently use, it can be lowered (e.g. to compare paths) but not raised beyond
+    // DetectIsa()
+    Isa getIsa();
+    void setIsa(Isa isa);
+
+    const char *IsaName(Isa isa);
+
+    // sin and cos of the fixed point phases phase + i * increment (one cycle is 2^64, see core/Clock.hpp)
+    void SinCos(uint64_t phase, uint64_t increment, float *sin, float *cos, int count);
+    void Sin(uint64_t phase, uint64_t increment, float *sin, int count);
+
+    // sin and cos of angles in radians
+    void SinCos(const float *radians, float *sin, float *cos, int count);
+}
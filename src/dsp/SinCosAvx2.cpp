@@ -0,0 +1,24 @@
+// AVX2 build of the sine/cosine kernels, compiled with AVX2 target flags (see CMakeLists.txt)
+#if defined(DMC_DSP_X86_DISPATCH)
+
+#include "SinCosKernel.inl"
+
+namespace Dsp
+{
+    void SinCosAvx2(uint64_t phase, uint64_t increment, float *sin, float *cos, int count)
+    {
+        KernelSinCosPhase(phase, increment, sin, cos, count);
+    }
+
+    void SinAvx2(uint64_t phase, uint64_t increment, float *sin, int count)
+    {
+        KernelSinPhase(phase, increment, sin, count);
+    }
+
+    void SinCosRadiansAvx2(const float *radians, float *sin, float *cos, int count)
+    {
+        KernelSinCosRadians(radians, sin, cos, count);
+    }
+}
+
+#endif
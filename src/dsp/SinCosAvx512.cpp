@@ -0,0 +1,24 @@
+// AVX-512 build of the sine/cosine kernels, compiled with AVX-512 target flags (see CMakeLists.txt)
+#if defined(DMC_DSP_X86_DISPATCH)
+
+#include "SinCosKernel.inl"
+
+namespace Dsp
+{
+    void SinCosAvx512(uint64_t phase, uint64_t increment, float *sin, float *cos, int count)
+    {
+        KernelSinCosPhase(phase, increment, sin, cos, count);
+    }
+
+    void SinAvx512(uint64_t phase, uint64_t increment, float *sin, int count)
+    {
+        KernelSinPhase(phase, increment, sin, count);
+    }
+
+    void SinCosRadiansAvx512(const float *radians, float *sin, float *cos, int count)
+    {
+        KernelSinCosRadians(radians, sin, cos, count);
+    }
+}
+
+#endif
@@ -0,0 +1,91 @@
+// Body of the sine/cosine kernels, included by one translation unit per instruction set and compiled with that
+// unit's target flags. Everything is in an anonymous namespace so each copy keeps internal linkage. The loops are
+// branch free so the compiler vectorizes them for the target.
+
+#include <bit>
+#include <cstdint>
+
+namespace
+{
+    // Minimax polynomials on [-PI/4, PI/4] (Cephes sinf/cosf)
+    constexpr float SinCoefficient1 = -1.6666654611e-1f;
+    constexpr float SinCoefficient2 = 8.3321608736e-3f;
+    constexpr float SinCoefficient3 = -1.9515295891e-4f;
+    constexpr float CosCoefficient1 = 4.166664568298827e-2f;
+    constexpr float CosCoefficient2 = -1.388731625493765e-3f;
+    constexpr float CosCoefficient3 = 2.443315711809948e-5f;
+
+    // sin and cos of quadrant * PI / 2 + a with a in [-PI/4, PI/4]
+    inline void SinCosQuadrant(uint32_t quadrant, float a, float &sinOut, float &cosOut)
+    {
+        const float a2 = a * a;
+        const float s = a + a * a2 * (SinCoefficient1 + a2 * (SinCoefficient2 + a2 * SinCoefficient3));
+        const float c = 1.0f - 0.5f * a2 + a2 * a2 * (CosCoefficient1 + a2 * (CosCoefficient2 + a2 * CosCoefficient3));
+
+        // Quadrants 1 and 3 swap sin and cos, the signs follow the quadrant. Selected with bit operations,
+        // conditionals keep the compiler from vectorizing the loops.
+        const uint32_t swap = 0u - (quadrant & 1);
+        const uint32_t sBits = std::bit_cast<uint32_t>(s);
+        const uint32_t cBits = std::bit_cast<uint32_t>(c);
+        sinOut = std::bit_cast<float>(((cBits & swap) | (sBits & ~swap)) ^ ((quadrant & 2) << 30));
+        cosOut = std::bit_cast<float>(((sBits & swap) | (cBits & ~swap)) ^ (((quadrant + 1) & 2) << 30));
+    }
+
+    // Splits a fixed point phase in the nearest quadrant and the angle left over in [-PI/4, PI/4]
+    inline void ReducePhase(uint64_t phase, uint32_t &quadrant, float &a)
+    {
+        constexpr uint64_t Half = uint64_t(1) << 61;
+        constexpr uint64_t Mask = (uint64_t(1) << 62) - 1;
+        constexpr float Scale = static_cast<float>(1.5707963267948966 / 1073741824.0); // PI / 2 per 2^30
+
+        const uint64_t shifted = phase + Half;
+        quadrant = static_cast<uint32_t>(shifted >> 62);
+        const int32_t residual = static_cast<int32_t>(static_cast<int64_t>((shifted & Mask) - Half) >> 32);
+        a = static_cast<float>(residual) * Scale;
+    }
+
+    void KernelSinCosPhase(uint64_t phase, uint64_t increment, float *sinOut, float *cosOut, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            uint32_t quadrant;
+            float a;
+            ReducePhase(phase, quadrant, a);
+            SinCosQuadrant(quadrant, a, sinOut[i], cosOut[i]);
+            phase += increment;
+        }
+    }
+
+    void KernelSinPhase(uint64_t phase, uint64_t increment, float *sinOut, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            uint32_t quadrant;
+            float a;
+            ReducePhase(phase, quadrant, a);
+
+            float unused;
+            SinCosQuadrant(quadrant, a, sinOut[i], unused);
+            phase += increment;
+        }
+    }
+
+    void KernelSinCosRadians(const float *radians, float *sinOut, float *cosOut, int count)
+    {
+        // Cody-Waite reduction by PI / 2 in three parts, the first two have few enough bits that k times them is
+        // exact. The rounding constant gives round to nearest without a call.
+        constexpr float TwoOverPi = 0.636619772367581343f;
+        constexpr float PiOverTwo1 = 1.5703125f;
+        constexpr float PiOverTwo2 = 4.837512969970703125e-4f;
+        constexpr float PiOverTwo3 = 7.54978995489188216e-8f;
+        constexpr float Round = 12582912.0f; // 1.5 * 2^23
+
+        for (int i = 0; i < count; i++)
+        {
+            const float x = radians[i];
+            const float k = (x * TwoOverPi + Round) - Round;
+            const float a = ((x - k * PiOverTwo1) - k * PiOverTwo2) - k * PiOverTwo3;
+            SinCosQuadrant(static_cast<uint32_t>(static_cast<int32_t>(k)), a, sinOut[i], cosOut[i]);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+// SSE4.2 build of the sine/cosine kernels, compiled with SSE4.2 target flags (see CMakeLists.txt)
+#if defined(DMC_DSP_X86_DISPATCH)
+
+#include "SinCosKernel.inl"
+
+namespace Dsp
+{
+    void SinCosSse42(uint64_t phase, uint64_t increment, float *sin, float *cos, int count)
+    {
+        KernelSinCosPhase(phase, increment, sin, cos, count);
+    }
+
+    void SinSse42(uint64_t phase, uint64_t increment, float *sin, int count)
+    {
+        KernelSinPhase(phase, increment, sin, count);
+    }
+
+    void SinCosRadiansSse42(const float *radians, float *sin, float *cos, int count)
+    {
+        KernelSinCosRadians(radians, sin, cos, count);
+    }
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "Application.hpp"
 
+#include <algorithm>
+
 static void glfw_error_callback(int error, const char *description)
 {
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
@@ -7,6 +9,12 @@ static void glfw_error_callback(int error, const char *description)
 
 void Application::Start()
 {
+    // Run the simulation on its own thread so rendering never stalls it
+    if (p_Simulation != nullptr)
+    {
+        p_Simulation->Launch();
+    }
+
     // Main loop
     while (isRunning())
     {
@@ -24,6 +32,10 @@ void Application::Start()
     }
 
     // While loop exits due to user closing the window
+    if (p_Simulation != nullptr)
+    {
+        p_Simulation->Shutdown();
+    }
     Finalize();
 }
 
@@ -90,15 +102,19 @@ void Application::Initialize()
 
 void Application::Update()
 {
-    if (p_Simulation != nullptr)
+    // A launched simulation advances on its own thread
+    if (p_Simulation != nullptr && !p_Simulation->isLaunched())
     {
-        p_Simulation->RenderControls();
-
         for (int i = 0; i < p_Simulation->getUpdateCountPerFrame(); i++)
         {
             p_Simulation->Update();
         }
-        p_Simulation->RenderObjects();
+        p_Simulation->PublishObjects();
+    }
+
+    for (auto renderable : m_Renderables)
+    {
+        renderable->Render();
     }
 }
 
@@ -199,4 +215,20 @@ void Application::ClearSimulation()
     p_Simulation = nullptr;
 }
 
+void Application::AddRenderable(Renderable *renderable)
+{
+    if (renderable == nullptr)
+    {
+        fprintf(stderr, "Application::AddRenderable: Renderable is nullptr\n");
+        return;
+    }
+
+    m_Renderables.push_back(renderable);
+}
+
+void Application::RemoveRenderable(Renderable *renderable)
+{
+    m_Renderables.erase(std::remove(m_Renderables.begin(), m_Renderables.end(), renderable), m_Renderables.end());
+}
+
 bool Application::isRunning() const { return glfwWindowShouldClose(m_Window) == 0; }
\ No newline at end of file
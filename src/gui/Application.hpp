@@ -11,8 +11,10 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
-#include "Simulation.hpp"
+#include "core/Renderable.hpp"
+#include "core/Simulation.hpp"
 
 struct ApplicationParams
 {
@@ -47,6 +49,10 @@ public:
     virtual Simulation *GetSimulation();
     virtual void ClearSimulation();
 
+    // GUI panels drawn every frame after the simulation has been updated
+    virtual void AddRenderable(Renderable *renderable);
+    virtual void RemoveRenderable(Renderable *renderable);
+
     bool isRunning() const;
 
 protected:
@@ -54,4 +60,6 @@ protected:
 
     ApplicationParams m_AppParams;
     Simulation *p_Simulation = nullptr;
+
+    std::vector<Renderable *> m_Renderables;
 };
@@ -0,0 +1,38 @@
+#include "SignalPlot.hpp"
+
+#include <imgui.h>
+#include <implot.h>
+
+void SignalPlot::Render()
+{
+    if (p_SignalDisplay == nullptr)
+    {
+        return;
+    }
+
+    const SignalSnapshot &snapshot = p_SignalDisplay->getSnapshot();
+
+    if (ImGui::Begin("Signal Display"))
+    {
+        if (ImPlot::BeginPlot("Signal Plot"))
+        {
+            ImPlot::SetupAxis(ImAxis_X1, "Count");
+            // ImPlot::SetupAxisFormat(ImAxis_X1, "%d Count");
+
+            ImPlot::SetupAxis(ImAxis_Y1, "Amplitude");
+            ImPlot::SetupAxisFormat(ImAxis_Y1, "%0.1f V");
+
+            if (snapshot.quadrature.empty())
+            {
+                ImPlot::PlotLine("Signal", snapshot.signal.data(), (int)snapshot.signal.size());
+            }
+            else
+            {
+                ImPlot::PlotLine("I", snapshot.signal.data(), (int)snapshot.signal.size());
+                ImPlot::PlotLine("Q", snapshot.quadrature.data(), (int)snapshot.quadrature.size());
+            }
+            ImPlot::EndPlot();
+        }
+    }
+    ImGui::End();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "core/Renderable.hpp"
+#include "signal/SignalDisplayObject.hpp"
+
+// Plots the latest snapshot published by a SignalDisplayObject
+class SignalPlot : public Renderable
+{
+public:
+    SignalPlot(SignalDisplayObject *signalDisplay) : p_SignalDisplay(signalDisplay) {}
+
+    void Render() override;
+
+protected:
+    SignalDisplayObject *p_SignalDisplay = nullptr;
+};
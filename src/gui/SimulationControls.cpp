@@ -0,0 +1,72 @@
+#include "SimulationControls.hpp"
+
+#include <imgui.h>
+
+void SimulationControls::Render()
+{
+    if (p_Simulation == nullptr)
+    {
+        return;
+    }
+
+    // Read the published status and send changes back as commands, the simulation may be running on its own thread
+    const SimulationStatus &status = p_Simulation->getStatus();
+
+    ImGui::Begin("Simulation Controls");
+
+    if (ImGui::CollapsingHeader("Simulation Parameters"))
+    {
+        ImGui::Text("Time Step: %.2f ns", status.params.simTimeStep * 1e9);
+        if (ImGui::Button("+"))
+        {
+            p_Simulation->PostCommand({SimulationCommand::Type::SetTimeStep, status.params.simTimeStep * 2});
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("-"))
+        {
+            p_Simulation->PostCommand({SimulationCommand::Type::SetTimeStep, status.params.simTimeStep / 2});
+        }
+
+        // plus and minus buttons to increment/decrement update count per frame
+        int updateCountPerFrame = status.params.updateCountPerFrame;
+        ImGui::Text("Update Count Per Frame: %d", updateCountPerFrame);
+        if (ImGui::InputInt("##updateCountPerFrame", &updateCountPerFrame, 1, 5))
+        {
+            p_Simulation->PostCommand({SimulationCommand::Type::SetUpdateCountPerFrame, static_cast<double>(updateCountPerFrame)});
+        }
+
+        int blockSize = status.params.blockSize;
+        ImGui::Text("Block Size: %d", blockSize);
+        if (ImGui::InputInt("##blockSize", &blockSize, 1, 64))
+        {
+            p_Simulation->PostCommand({SimulationCommand::Type::SetBlockSize, static_cast<double>(blockSize)});
+        }
+
+        ImGui::Text("Start Time: %.2f ns", status.params.simStartTime * 1e9);
+        ImGui::Text("End Time: %.2f ns", status.params.simEndTime * 1e9);
+    }
+
+    // Display simulation control
+    if (ImGui::CollapsingHeader("Simulation Control"))
+    {
+        if (ImGui::Button("Start"))
+        {
+            p_Simulation->PostCommand({SimulationCommand::Type::Start});
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Reset"))
+        {
+            p_Simulation->PostCommand({SimulationCommand::Type::Reset});
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Stop"))
+        {
+            p_Simulation->PostCommand({SimulationCommand::Type::Stop});
+        }
+    }
+
+    // Display simulation time in nanoseconds
+    ImGui::Text("Simulation Time: %.2f ns", status.simulationTime * 1e9);
+
+    ImGui::End();
+}
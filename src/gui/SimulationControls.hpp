@@ -0,0 +1,16 @@
+#pragma once
+
+#include "core/Renderable.hpp"
+#include "core/Simulation.hpp"
+
+// ImGui panel for inspecting and controlling a Simulation
+class SimulationControls : public Renderable
+{
+public:
+    SimulationControls(Simulation *simulation) : p_Simulation(simulation) {}
+
+    void Render() override;
+
+protected:
+    Simulation *p_Simulation = nullptr;
+};
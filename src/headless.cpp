@@ -0,0 +1,377 @@
+#include "core/BatchRunner.hpp"
+#include "core/Constants.hpp"
+#include "core/EnsembleRunner.hpp"
+#include "core/ParameterSweep.hpp"
+#include "core/Scenario.hpp"
+#include "core/Simulation.hpp"
+
+#include "signal/ChirpSignalGenerator.hpp"
+#include "signal/SignalDisplayObject.hpp"
+#include "signal/NcoSignalGenerator.hpp"
+#include "signal/NoiseSourceObject.hpp"
+#include "signal/SineSignalGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <stdio.h>
+#include <vector>
+
+static void printUsage(const char *program)
+{
+    printf("Usage: %s [--step <sec>] [--end <sec>] [--block <samples>] [--threads <count>]\n"
+           "       [--load-state <path>] [--save-state <path>] [--runs <count>] [--seed <seed>]\n"
+           "       [--pri <sec> --pulse-width <sec>] [--event] [--nco | --chirp <Hz>] [--frequency <Hz>] [--carrier <Hz>]\n"
+           "       [--noise <dBm/Hz>]\n"
+           "       [--sweep <name>=<min>:<max>[:<count>]]... [--lhs <samples>] [--sweep-out <path>]\n"
+           "Swept names are SimulationParameters fields or signal.<SignalParameters field>\n", program);
+}
+
+static SignalParameters defaultSignalParameters()
+{
+    SignalParameters signalParams;
+    signalParams.amplitude = 10.0;                         // V
+    signalParams.frequency = 1000.0 / (2 * Constants::PI); // Hz
+    return signalParams;
+}
+
+// Signal of every scenario built by this run, set from the command line
+static SignalParameters s_SignalParameters = defaultSignalParameters();
+static bool s_UseNco = false;
+static double s_ChirpBandwidth = 0.0; // Linear FM pulses of this bandwidth instead of a sine when non-zero
+static bool s_Baseband = false; // Record the complex envelope around the carrier instead of the real signal
+static bool s_AddNoise = false; // Add noise of s_NoiseDensity to the complex envelope
+static double s_NoiseDensity = -174.0;
+
+// A sine source (libm or NCO) or chirp pulse train, optionally with noise, feeding a display, the seed picks the starting phase of the sine
+class SineScenario : public Scenario
+{
+public:
+    SineScenario(const SimulationParameters &params, SignalParameters signalParams = s_SignalParameters) : Scenario(params)
+    {
+        signalParams.phase += static_cast<double>(params.seed >> 11) * 0x1.0p-53 * 2 * Constants::PI;
+
+        if (s_ChirpBandwidth != 0.0)
+        {
+            ChirpSettings chirpSettings;
+            chirpSettings.bandwidth = s_ChirpBandwidth;
+            generator = &AddObject<ChirpSignalGenerator>(signalParams, chirpSettings);
+        }
+        else if (s_UseNco)
+        {
+            generator = &AddObject<NcoSignalGenerator>(signalParams);
+        }
+        else
+        {
+            generator = &AddObject<SineSignalGenerator>(signalParams);
+        }
+        display = &AddObject<SignalDisplayObject>(4096);
+        if (s_AddNoise)
+        {
+            NoiseSettings noiseSettings;
+            noiseSettings.noiseDensity = s_NoiseDensity;
+            noiseSettings.channels = 1;
+            noise = &AddObject<NoiseSourceObject>(noiseSettings);
+            m_Simulation.Connect(generator->getComplexOutput(), noise->getInput());
+            m_Simulation.Connect(noise->getOutput(), display->getComplexInput());
+        }
+        else if (s_Baseband)
+        {
+            m_Simulation.Connect(generator->getComplexOutput(), display->getComplexInput());
+        }
+        else
+        {
+            m_Simulation.Connect(generator->getOutput(), display->getInput());
+        }
+    }
+
+    SignalGenerator *generator;
+    NoiseSourceObject *noise = nullptr;
+    SignalDisplayObject *display;
+};
+
+// Mean and RMS of the samples left in the display at the end of a run
+static std::vector<double> measureSineScenario(Scenario &scenario)
+{
+    const std::vector<float> &signal = static_cast<SineScenario &>(scenario).display->getSignal();
+
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (float value : signal)
+    {
+        sum += value;
+        sumSquares += static_cast<double>(value) * value;
+    }
+
+    const double count = static_cast<double>(std::max<size_t>(signal.size(), 1));
+    return {sum / count, std::sqrt(sumSquares / count)};
+}
+
+static int runEnsemble(const SimulationParameters &simParams, const EnsembleParameters &ensembleParams)
+{
+    EnsembleRunner ensemble(
+        simParams, [](const SimulationParameters &params) { return std::make_unique<SineScenario>(params); },
+        &measureSineScenario, {"mean", "rms"});
+
+    EnsembleResult result;
+    try
+    {
+        result = ensemble.Run(ensembleParams);
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "headless: %s\n", e.what());
+        return 1;
+    }
+
+    printf("Runs:               %d\n", result.runCount);
+    for (size_t m = 0; m < result.metrics.size(); m++)
+    {
+        const MetricSummary &metric = result.metrics[m];
+        printf("%-8s mean %.9e  std %.9e  min %.9e  max %.9e\n", ensemble.getMetricNames()[m].c_str(), metric.mean,
+               std::sqrt(metric.Variance()), metric.min, metric.max);
+    }
+    printf("Samples:            %llu\n", static_cast<unsigned long long>(result.sampleCount));
+    printf("Wall time:          %.6f sec\n", result.wallTime);
+    printf("Samples per second: %.3e\n", result.samplesPerSecond);
+
+    return 0;
+}
+
+// Parses <name>=<min>:<max>[:<count>]
+static bool parseSweepDimension(const char *text, SweepDimension &dimension)
+{
+    const char *equals = strchr(text, '=');
+    if (equals == nullptr)
+    {
+        return false;
+    }
+    dimension.name.assign(text, equals);
+
+    char *end = nullptr;
+    dimension.min = strtod(equals + 1, &end);
+    if (*end != ':')
+    {
+        return false;
+    }
+    dimension.max = strtod(end + 1, &end);
+    dimension.count = 1;
+    if (*end == ':')
+    {
+        dimension.count = atoi(end + 1);
+    }
+    else if (*end != '\0')
+    {
+        return false;
+    }
+
+    SimulationParameters simParams;
+    SignalParameters signalParams;
+    return ParameterSweep::SetSimulationParameter(simParams, dimension.name, 0.0) ||
+           (dimension.name.rfind("signal.", 0) == 0 && SetSignalParameter(signalParams, dimension.name.substr(7), 0.0));
+}
+
+static int runSweep(const SimulationParameters &simParams, const SweepParameters &sweepParams)
+{
+    auto factory = [](const SimulationParameters &params, const SweepPoint &point)
+    {
+        SignalParameters signalParams = s_SignalParameters;
+        for (size_t d = 0; d < point.getSize(); d++)
+        {
+            if (point.getName(d).rfind("signal.", 0) == 0)
+            {
+                SetSignalParameter(signalParams, point.getName(d).substr(7), point.getValue(d));
+            }
+        }
+        return std::make_unique<SineScenario>(params, signalParams);
+    };
+    ParameterSweep sweep(simParams, factory, &measureSineScenario, {"mean", "rms"});
+
+    SweepResult result;
+    try
+    {
+        result = sweep.Run(sweepParams);
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "headless: %s\n", e.what());
+        return 1;
+    }
+
+    printf("Points:             %d -> %s\n", result.pointCount, sweepParams.outputPath.c_str());
+    printf("Samples:            %llu\n", static_cast<unsigned long long>(result.sampleCount));
+    printf("Wall time:          %.6f sec\n", result.wallTime);
+    printf("Samples per second: %.3e\n", result.samplesPerSecond);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    // Setup the Simulation
+    SimulationParameters simParams;
+    simParams.simTimeStep = 1e-9 * pow(2, 12); // 4096 ns
+    simParams.simStartTime = 0.0;              // 0 sec
+    simParams.simEndTime = 1.0;                // 1 sec
+    simParams.blockSize = 4096;
+
+    const char *loadStatePath = nullptr;
+    const char *saveStatePath = nullptr;
+    EnsembleParameters ensembleParams;
+    ensembleParams.runCount = 0;
+    SweepParameters sweepParams;
+    sweepParams.outputPath = "sweep.csv";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--step") == 0 && i + 1 < argc)
+        {
+            simParams.simTimeStep = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--end") == 0 && i + 1 < argc)
+        {
+            simParams.simEndTime = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--block") == 0 && i + 1 < argc)
+        {
+            simParams.blockSize = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            simParams.threadCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--load-state") == 0 && i + 1 < argc)
+        {
+            loadStatePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--save-state") == 0 && i + 1 < argc)
+        {
+            saveStatePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+        {
+            ensembleParams.runCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            ensembleParams.baseSeed = strtoull(argv[++i], nullptr, 0);
+            simParams.seed = ensembleParams.baseSeed;
+        }
+        else if (strcmp(argv[i], "--pri") == 0 && i + 1 < argc)
+        {
+            s_SignalParameters.pulseRepetitionInterval = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--pulse-width") == 0 && i + 1 < argc)
+        {
+            s_SignalParameters.pulseWidth = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--frequency") == 0 && i + 1 < argc)
+        {
+            s_SignalParameters.frequency = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--carrier") == 0 && i + 1 < argc)
+        {
+            s_SignalParameters.carrierFrequency = strtod(argv[++i], nullptr);
+            s_Baseband = true;
+        }
+        else if (strcmp(argv[i], "--noise") == 0 && i + 1 < argc)
+        {
+            s_NoiseDensity = strtod(argv[++i], nullptr);
+            s_AddNoise = true;
+        }
+        else if (strcmp(argv[i], "--nco") == 0)
+        {
+            s_UseNco = true;
+        }
+        else if (strcmp(argv[i], "--chirp") == 0 && i + 1 < argc)
+        {
+            s_ChirpBandwidth = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--event") == 0)
+        {
+            simParams.eventDriven = true;
+        }
+        else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc)
+        {
+            SweepDimension dimension;
+            if (!parseSweepDimension(argv[++i], dimension))
+            {
+                fprintf(stderr, "headless: invalid sweep '%s'\n", argv[i]);
+                printUsage(argv[0]);
+                return 1;
+            }
+            sweepParams.dimensions.push_back(dimension);
+        }
+        else if (strcmp(argv[i], "--lhs") == 0 && i + 1 < argc)
+        {
+            sweepParams.mode = SweepMode::LatinHypercube;
+            sweepParams.sampleCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--sweep-out") == 0 && i + 1 < argc)
+        {
+            sweepParams.outputPath = argv[++i];
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Sweep mode, one CSV row per point
+    if (!sweepParams.dimensions.empty())
+    {
+        sweepParams.threadCount = simParams.threadCount;
+        sweepParams.seed = simParams.seed;
+        return runSweep(simParams, sweepParams);
+    }
+
+    // Monte Carlo mode, independent runs spread over the threads
+    if (ensembleParams.runCount > 0)
+    {
+        ensembleParams.threadCount = simParams.threadCount;
+        return runEnsemble(simParams, ensembleParams);
+    }
+
+    SineScenario scenario(simParams);
+    Simulation &simulation = scenario.getSimulation();
+
+    // Run the simulation flat out until the end time, continuing from a checkpoint if one is given
+    BatchRunner runner(&simulation);
+    BatchResult result;
+    try
+    {
+        if (loadStatePath != nullptr)
+        {
+            simulation.LoadStateFromFile(loadStatePath);
+            simulation.getSimulationEndTime() = simParams.simEndTime;
+            result = runner.Resume();
+        }
+        else
+        {
+            result = runner.Run();
+        }
+
+        if (saveStatePath != nullptr)
+        {
+            simulation.SaveStateToFile(saveStatePath);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "headless: %s\n", e.what());
+        return 1;
+    }
+
+    printf("Updates:            %llu\n", static_cast<unsigned long long>(result.updateCount));
+    printf("Samples:            %llu\n", static_cast<unsigned long long>(result.sampleCount));
+    printf("Skipped samples:    %llu\n", static_cast<unsigned long long>(result.skippedSampleCount));
+    printf("Simulated time:     %.6f sec\n", result.simulatedTime);
+    printf("Wall time:          %.6f sec\n", result.wallTime);
+    printf("Samples per second: %.3e\n", result.samplesPerSecond);
+
+    return 0;
+}
@@ -1,8 +1,14 @@
-#include "core/Application.hpp"
+#include "gui/Application.hpp"
+#include "gui/SignalPlot.hpp"
+#include "gui/SimulationControls.hpp"
+
+#include "core/Constants.hpp"
 #include "core/Simulation.hpp"
 
 #include "signal/SignalDisplayObject.hpp"
+#include "signal/SineSignalGenerator.hpp"
 
+#include <cmath>
 #include <stdio.h>
 #include <vector>
 
@@ -21,12 +27,24 @@ int main(int argc, char **argv)
     simParams.updateCountPerFrame = 10;
     Simulation *simulation = app.CreateSimulation(simParams);
 
-    // Add an object to the Simulation
+    // Add a sine source feeding a display to the Simulation
+    SignalParameters signalParams;
+    signalParams.amplitude = 10.0;                         // V
+    signalParams.frequency = 1000.0 / (2 * Constants::PI); // Hz
+    SineSignalGenerator signalGenerator(signalParams);
     SignalDisplayObject signalDisplay(4096);
+    simulation->AddObject(&signalGenerator);
     simulation->AddObject(&signalDisplay);
+    simulation->Connect(signalGenerator.getOutput(), signalDisplay.getInput());
+
+    // Add the GUI panels
+    SimulationControls simulationControls(simulation);
+    app.AddRenderable(&simulationControls);
+    SignalPlot signalPlot(&signalDisplay);
+    app.AddRenderable(&signalPlot);
 
     // Begins the applications main loop
     app.Start();
 
     return 0;
-}
\ No newline at end of file
+}
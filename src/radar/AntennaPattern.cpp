@@ -0,0 +1,126 @@
+#include "AntennaPattern.hpp"
+
+#include "core/Constants.hpp"
+#include "core/TableCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+    std::atomic<uint64_t> s_NextVersion{1};
+
+    double Sinc(double x)
+    {
+        if (std::fabs(x) < 1e-9)
+        {
+            return 1.0;
+        }
+        return std::sin(Constants::PI * x) / (Constants::PI * x);
+    }
+}
+
+AntennaPattern::AntennaPattern(const AntennaSettings &settings)
+{
+    SetSettings(settings);
+}
+
+void AntennaPattern::SetSettings(const AntennaSettings &settings)
+{
+    if (settings.tableSize < 2 || settings.fieldOfView <= 0.0 || settings.frequency <= 0.0)
+    {
+        throw std::invalid_argument("AntennaPattern needs a frequency, a field of view and at least 2 table points per axis");
+    }
+
+    m_Settings = settings;
+    m_Version = s_NextVersion.fetch_add(1, std::memory_order_relaxed);
+    BuildTable();
+}
+
+void AntennaPattern::Gains(double azimuth, double elevation, Complex gains[Horns]) const
+{
+    // Direction cosines of the look direction, y to the left and z up
+    const double u = std::cos(elevation) * std::sin(azimuth);
+    const double v = std::sin(elevation);
+    const double lambda = Constants::SpeedOfLight / m_Settings.frequency;
+
+    // A and C squint left, A and B up
+    const double side[Horns] = {1.0, -1.0, 1.0, -1.0};
+    const double level[Horns] = {1.0, 1.0, -1.0, -1.0};
+    for (int horn = 0; horn < Horns; horn++)
+    {
+        const double uk = std::sin(side[horn] * m_Settings.squintAzimuth);
+        const double vk = std::sin(level[horn] * m_Settings.squintElevation);
+        const double magnitude = Sinc(m_Settings.hornWidth / lambda * (u - uk)) * Sinc(m_Settings.hornHeight / lambda * (v - vk));
+
+        const double xk = 0.5 * side[horn] * m_Settings.phaseCenterSpacing;
+        const double yk = 0.5 * level[horn] * m_Settings.phaseCenterSpacing;
+        const double phase = 2 * Constants::PI / lambda * (xk * u + yk * v);
+        gains[horn] = Complex(static_cast<float>(magnitude * std::cos(phase)), static_cast<float>(magnitude * std::sin(phase)));
+    }
+}
+
+void AntennaPattern::BuildTable()
+{
+    const AntennaSettings &s = m_Settings;
+    char key[256];
+    std::snprintf(key, sizeof(key), "antenna.%.17g.%.17g.%.17g.%.17g.%.17g.%.17g.%.17g.%d", s.frequency, s.hornWidth, s.hornHeight,
+                  s.squintAzimuth, s.squintElevation, s.phaseCenterSpacing, s.fieldOfView, s.tableSize);
+
+    m_Key = key;
+    m_Table = TableCache::Shared().GetOrBuild<AlignedVector<Complex>>(m_Key, [this]()
+    {
+        const int size = m_Settings.tableSize;
+        const double step = 2 * m_Settings.fieldOfView / (size - 1);
+        AlignedVector<Complex> table(static_cast<size_t>(size) * size * Horns);
+        for (int j = 0; j < size; j++)
+        {
+            for (int i = 0; i < size; i++)
+            {
+                Gains(-m_Settings.fieldOfView + i * step, -m_Settings.fieldOfView + j * step, &table[(static_cast<size_t>(j) * size + i) * Horns]);
+            }
+        }
+        return table;
+    });
+}
+
+void AntennaPattern::Evaluate(const float *azimuth, const float *elevation, Complex *gains, int count) const
+{
+    const int size = m_Settings.tableSize;
+    const float fieldOfView = static_cast<float>(m_Settings.fieldOfView);
+    const float scale = static_cast<float>((size - 1) / (2 * m_Settings.fieldOfView));
+    const float last = static_cast<float>(size - 1);
+
+    // The four horns of a grid point are 8 consecutive floats, so each corner is one vector load
+    const float *table = reinterpret_cast<const float *>(m_Table->data());
+    float *out = reinterpret_cast<float *>(gains);
+    for (int n = 0; n < count; n++)
+    {
+        const float x = std::clamp((azimuth[n] + fieldOfView) * scale, 0.0f, last);
+        const float y = std::clamp((elevation[n] + fieldOfView) * scale, 0.0f, last);
+        const int i = std::min(static_cast<int>(x), size - 2);
+        const int j = std::min(static_cast<int>(y), size - 2);
+        const float fx = x - static_cast<float>(i);
+        const float fy = y - static_cast<float>(j);
+
+        const float *p00 = table + (static_cast<size_t>(j) * size + i) * 2 * Horns;
+        const float *p01 = p00 + 2 * Horns;
+        const float *p10 = p00 + static_cast<size_t>(size) * 2 * Horns;
+        const float *p11 = p10 + 2 * Horns;
+        const float w00 = (1.0f - fx) * (1.0f - fy);
+        const float w01 = fx * (1.0f - fy);
+        const float w10 = (1.0f - fx) * fy;
+        const float w11 = fx * fy;
+
+        // Computed into a local first, the output may alias the table as far as the compiler knows
+        float value[2 * Horns];
+        for (int k = 0; k < 2 * Horns; k++)
+        {
+            value[k] = w00 * p00[k] + w01 * p01[k] + w10 * p10[k] + w11 * p11[k];
+        }
+        std::copy(value, value + 2 * Horns, out + static_cast<size_t>(n) * 2 * Horns);
+    }
+}
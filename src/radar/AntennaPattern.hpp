@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/AlignedAllocator.hpp"
+#include "core/Port.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct AntennaSettings
+{
+    double frequency = 10e9;          // Hz
+    double hornWidth = 0.06;          // m, aperture of one horn in azimuth
+    double hornHeight = 0.06;         // m, aperture of one horn in elevation
+    double squintAzimuth = 0.1;       // rad, beam offset of every horn from boresight in azimuth
+    double squintElevation = 0.1;     // rad, beam offset of every horn from boresight in elevation
+    double phaseCenterSpacing = 0.0;  // m, distance between the phase centers of neighbouring horns
+    double fieldOfView = 0.5;         // rad, the table covers [-fieldOfView, fieldOfView] on both axes
+    int tableSize = 257;              // Table points per axis
+};
+
+// Four squinted horns of an amplitude comparison monopulse antenna, looking along +x with y to the left and z up.
+// Horn A is up left, B up right, C down left and D down right, so A + C - B - D is the azimuth difference and
+// A + B - C - D the elevation difference.
+//
+// Every horn is a uniformly illuminated rectangular aperture, its voltage gain at direction cosines (u, v) is
+//
+//   sinc(width / lambda (u - u_k)) sinc(height / lambda (v - v_k)) e^(j 2 PI / lambda (x_k u + y_k v))
+//
+// with (u_k, v_k) its squinted beam center and (x_k, y_k) its phase center. The gains are computed once on an
+// azimuth/elevation grid shared through TableCache and evaluated with bilinear interpolation, directions outside
+// the table take the value at its edge. A pattern only holds the table of its current settings, tables of earlier
+// settings (e.g. the frequencies of a sweep) are freed by the cache once no pattern uses them.
+class AntennaPattern
+{
+public:
+    static constexpr int Horns = 4;
+
+    AntennaPattern(const AntennaSettings &settings = AntennaSettings());
+
+    const AntennaSettings &getSettings() const { return m_Settings; }
+
+    // Rebuilds the table (or fetches it from the cache) and gives the pattern a new version
+    void SetSettings(const AntennaSettings &settings);
+
+    // Changes whenever the pattern does, unique over all patterns so users can tell when to recompute anything
+    // derived from it
+    uint64_t getVersion() const { return m_Version; }
+
+    // Identifies the settings, equal keys mean equal patterns
+    const std::string &getKey() const { return m_Key; }
+
+    // Gains of the four horns computed from the model, for reference and for building the table
+    void Gains(double azimuth, double elevation, Complex gains[Horns]) const;
+
+    // Gains of the four horns for count directions from the table, gains[i * Horns + horn]
+    void Evaluate(const float *azimuth, const float *elevation, Complex *gains, int count) const;
+
+private:
+    void BuildTable();
+
+    AntennaSettings m_Settings;
+    uint64_t m_Version = 0;
+    std::string m_Key;
+
+    // Grid point (azimuth index i, elevation index j) holds the four horns at [(j * tableSize + i) * Horns]
+    std::shared_ptr<const AlignedVector<Complex>> m_Table;
+};
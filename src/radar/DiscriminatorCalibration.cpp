@@ -0,0 +1,271 @@
+#include "DiscriminatorCalibration.hpp"
+
+#include "core/StateArchive.hpp"
+#include "core/TableCache.hpp"
+#include "dsp/Interpolate.hpp"
+#include "radar/AntennaPattern.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t CalibrationMagic = 0x44434D44; // "DMCD"
+    constexpr uint32_t CalibrationVersion = 1;
+
+    // Sweep points per table point, keeps the inversion error well below the interpolation error of the table
+    constexpr int SweepOversampling = 8;
+
+    // Sweeps one axis with the other one on boresight and inverts the monotonic part of the ratio around it
+    DiscriminatorCurve BuildCurve(const AntennaPattern &antenna, bool elevation, int tableSize)
+    {
+        const double fieldOfView = antenna.getSettings().fieldOfView;
+        const int sweepCount = SweepOversampling * (tableSize - 1) + 1;
+        const int center = (sweepCount - 1) / 2;
+        const double step = 2 * fieldOfView / (sweepCount - 1);
+
+        std::vector<double> ratio(sweepCount);
+        for (int k = 0; k < sweepCount; k++)
+        {
+            const double angle = (k - center) * step;
+            Complex gains[AntennaPattern::Horns];
+            if (elevation)
+            {
+                antenna.Gains(0.0, angle, gains);
+            }
+            else
+            {
+                antenna.Gains(angle, 0.0, gains);
+            }
+
+            const Complex sum = gains[0] + gains[1] + gains[2] + gains[3];
+            const Complex delta = elevation ? gains[0] + gains[1] - gains[2] - gains[3] : gains[0] + gains[2] - gains[1] - gains[3];
+            const double power = std::norm(sum);
+            ratio[k] = power > 0.0 ? (static_cast<double>(delta.real()) * sum.real() + static_cast<double>(delta.imag()) * sum.imag()) / power : 0.0;
+        }
+
+        // Past the first extremum on either side the ratio folds back and no longer identifies the angle
+        int lo = center;
+        int hi = center;
+        while (lo > 0 && ratio[lo - 1] < ratio[lo])
+        {
+            lo--;
+        }
+        while (hi < sweepCount - 1 && ratio[hi + 1] > ratio[hi])
+        {
+            hi++;
+        }
+        if (hi == lo)
+        {
+            throw std::runtime_error(std::string("DiscriminatorCalibration: the antenna has no ") + (elevation ? "elevation" : "azimuth") +
+                                     " slope at boresight");
+        }
+
+        DiscriminatorCurve curve;
+        const double ratioStep = (ratio[hi] - ratio[lo]) / (tableSize - 1);
+        curve.ratioMin = static_cast<float>(ratio[lo]);
+        curve.ratioScale = static_cast<float>(1.0 / ratioStep);
+        curve.angles.resize(tableSize);
+
+        int k = lo;
+        for (int n = 0; n < tableSize; n++)
+        {
+            const double target = std::min(ratio[lo] + n * ratioStep, ratio[hi]);
+            while (k < hi - 1 && ratio[k + 1] < target)
+            {
+                k++;
+            }
+            const double t = std::clamp((target - ratio[k]) / (ratio[k + 1] - ratio[k]), 0.0, 1.0);
+            curve.angles[n] = static_cast<float>((k - center + t) * step);
+        }
+        return curve;
+    }
+
+    void WriteCurve(StateWriter &writer, const DiscriminatorCurve &curve)
+    {
+        writer.Write(curve.ratioMin);
+        writer.Write(curve.ratioScale);
+        writer.WriteVector(std::vector<float>(curve.angles.begin(), curve.angles.end()));
+    }
+
+    DiscriminatorCurve ReadCurve(StateReader &reader)
+    {
+        DiscriminatorCurve curve;
+        reader.Read(curve.ratioMin);
+        reader.Read(curve.ratioScale);
+        if (!std::isfinite(curve.ratioMin) || !std::isfinite(curve.ratioScale) || curve.ratioScale <= 0.0f)
+        {
+            throw std::runtime_error("Discriminator calibration has a curve with an invalid ratio grid");
+        }
+
+        std::vector<float> angles;
+        reader.ReadVector(angles);
+        if (angles.size() < 2)
+        {
+            throw std::runtime_error("Discriminator calibration has a curve with less than 2 points");
+        }
+        curve.angles.assign(angles.begin(), angles.end());
+        return curve;
+    }
+}
+
+DiscriminatorCalibration::DiscriminatorCalibration(const AntennaPattern *antenna, int tableSize) : p_Antenna(antenna)
+{
+    setTableSize(tableSize);
+}
+
+void DiscriminatorCalibration::setTableSize(int tableSize)
+{
+    if (tableSize < 2)
+    {
+        throw std::invalid_argument("DiscriminatorCalibration needs at least 2 table points");
+    }
+    m_TableSize = tableSize;
+}
+
+void DiscriminatorCalibration::setAntenna(const AntennaPattern *antenna)
+{
+    p_Antenna = antenna;
+    m_AntennaVersion = 0;
+}
+
+std::string DiscriminatorCalibration::TableKey() const
+{
+    return "discriminator." + p_Antenna->getKey() + "." + std::to_string(m_TableSize);
+}
+
+std::shared_ptr<const DiscriminatorTables> DiscriminatorCalibration::Build() const
+{
+    return TableCache::Shared().GetOrBuild<DiscriminatorTables>(TableKey(), [this]()
+    {
+        DiscriminatorTables tables;
+        tables.azimuth = BuildCurve(*p_Antenna, false, m_TableSize);
+        tables.elevation = BuildCurve(*p_Antenna, true, m_TableSize);
+        return tables;
+    });
+}
+
+bool DiscriminatorCalibration::Update()
+{
+    if (p_Antenna == nullptr)
+    {
+        return false;
+    }
+    if (m_Current && m_AntennaVersion == p_Antenna->getVersion() && m_CurrentSize == m_TableSize)
+    {
+        return true;
+    }
+
+    // Tables loaded from a file or kept from before (e.g. for an earlier frequency) are reused as they are
+    std::string key = TableKey();
+    auto it = m_Tables.find(key);
+    if (it != m_Tables.end())
+    {
+        m_Current = it->second;
+    }
+    else
+    {
+        m_Current = Build();
+        if (m_KeepTables)
+        {
+            m_Tables.emplace(key, m_Current);
+        }
+    }
+
+    m_CurrentKey = std::move(key);
+    m_AntennaVersion = p_Antenna->getVersion();
+    m_CurrentSize = m_TableSize;
+    return true;
+}
+
+void DiscriminatorCalibration::Evaluate(const DiscriminatorCurve &curve, const Complex *ratio, float *angle, int count)
+{
+    // Real parts only, clamped to the ends of the curve (NaN gives its first angle)
+    Dsp::InterpolateUniform(curve.angles.data(), static_cast<int>(curve.angles.size()), curve.ratioMin, curve.ratioScale,
+                            reinterpret_cast<const float *>(ratio), 2, angle, count);
+}
+
+void DiscriminatorCalibration::EvaluateAzimuth(const Complex *ratio, float *angle, int count) const
+{
+    Evaluate(m_Current->azimuth, ratio, angle, count);
+}
+
+void DiscriminatorCalibration::EvaluateElevation(const Complex *ratio, float *angle, int count) const
+{
+    Evaluate(m_Current->elevation, ratio, angle, count);
+}
+
+void DiscriminatorCalibration::SaveToFile(const std::string &path) const
+{
+    std::map<std::string, std::shared_ptr<const DiscriminatorTables>> saved = m_Tables;
+    if (m_Current)
+    {
+        saved.emplace(m_CurrentKey, m_Current);
+    }
+
+    StateWriter writer;
+    writer.Write(CalibrationMagic);
+    writer.Write(CalibrationVersion);
+    writer.Write<uint64_t>(saved.size());
+    for (const auto &[key, tables] : saved)
+    {
+        writer.WriteString(key);
+        WriteCurve(writer, tables->azimuth);
+        WriteCurve(writer, tables->elevation);
+    }
+
+    const std::vector<uint8_t> &data = writer.getData();
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write discriminator calibration to " + path);
+    }
+}
+
+void DiscriminatorCalibration::LoadFromFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open discriminator calibration " + path);
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    StateReader reader(data);
+    if (reader.Read<uint32_t>() != CalibrationMagic)
+    {
+        throw std::runtime_error(path + " is not a discriminator calibration");
+    }
+    if (reader.Read<uint32_t>() != CalibrationVersion)
+    {
+        throw std::runtime_error("Discriminator calibration version is not supported");
+    }
+
+    // Read completely before anything is replaced, so a broken file leaves the calibration as it was
+    std::map<std::string, std::shared_ptr<const DiscriminatorTables>> loaded;
+    const uint64_t count = reader.Read<uint64_t>();
+    for (uint64_t n = 0; n < count; n++)
+    {
+        std::string key = reader.ReadString();
+        auto tables = std::make_shared<DiscriminatorTables>();
+        tables->azimuth = ReadCurve(reader);
+        tables->elevation = ReadCurve(reader);
+        loaded[std::move(key)] = std::move(tables);
+    }
+    if (!reader.isAtEnd())
+    {
+        throw std::runtime_error("Discriminator calibration " + path + " has trailing data");
+    }
+
+    for (auto &[key, tables] : loaded)
+    {
+        m_Tables[key] = std::move(tables);
+    }
+
+    // The current tables may have been replaced
+    m_Current.reset();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "core/AlignedAllocator.hpp"
+#include "core/Port.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class AntennaPattern;
+
+// Off-boresight angle of one axis as a function of its monopulse ratio, sampled on a uniform ratio grid
+struct DiscriminatorCurve
+{
+    float ratioMin = 0.0f;   // Ratio of the first point
+    float ratioScale = 0.0f; // Points per unit of ratio
+    AlignedVector<float> angles; // rad
+};
+
+struct DiscriminatorTables
+{
+    DiscriminatorCurve azimuth;
+    DiscriminatorCurve elevation;
+};
+
+// Turns monopulse ratios into angles for an AntennaPattern. The antenna model is swept once across its field of
+// view on each axis (azimuth on the elevation boresight and the other way around), the monotonic part of the
+// ratio around boresight is inverted onto a uniform ratio grid and evaluated with the Dsp::InterpolateUniform
+// kernels, ratios outside the curve give its end angles and NaN ratios its first angle.
+//
+// Tables are keyed by the antenna settings, so every frequency gets its own. They are shared through TableCache,
+// which frees them once no calibration uses them. The calibration only holds on to the tables of the current
+// antenna, tables loaded from a file and, with setKeepTables(), every table it built so they can be persisted
+// together and loaded back to skip the sweep. Update() only rebuilds when the antenna changed since the last call.
+class DiscriminatorCalibration
+{
+public:
+    DiscriminatorCalibration(const AntennaPattern *antenna = nullptr, int tableSize = 1024);
+
+    // Points per axis of the tables built from now on
+    void setTableSize(int tableSize);
+    int getTableSize() const { return m_TableSize; }
+
+    void setAntenna(const AntennaPattern *antenna);
+    const AntennaPattern *getAntenna() const { return p_Antenna; }
+
+    // Keeps every table built from now on for SaveToFile() (e.g. one per frequency of a sweep), off by default
+    void setKeepTables(bool keep) { m_KeepTables = keep; }
+    bool getKeepTables() const { return m_KeepTables; }
+
+    // Makes the tables match the antenna, cheap when nothing changed. Returns false without an antenna.
+    bool Update();
+
+    // Tables for the antenna as of the last Update(), nullptr before the first
+    const DiscriminatorTables *getTables() const { return m_Current.get(); }
+
+    // Angles (rad) from the real part of count monopulse ratios, needs a successful Update()
+    void EvaluateAzimuth(const Complex *ratio, float *angle, int count) const;
+    void EvaluateElevation(const Complex *ratio, float *angle, int count) const;
+
+    static void Evaluate(const DiscriminatorCurve &curve, const Complex *ratio, float *angle, int count);
+
+    // The current tables and every table loaded or kept so far, with the key of its antenna
+    void SaveToFile(const std::string &path) const;
+
+    // Adds the tables of a file, ones matching the antenna are used instead of sweeping it
+    void LoadFromFile(const std::string &path);
+
+private:
+    std::string TableKey() const;
+    std::shared_ptr<const DiscriminatorTables> Build() const;
+
+    const AntennaPattern *p_Antenna = nullptr;
+    int m_TableSize;
+    uint64_t m_AntennaVersion = 0;
+    int m_CurrentSize = 0;
+    std::string m_CurrentKey;
+    std::shared_ptr<const DiscriminatorTables> m_Current;
+    bool m_KeepTables = false;
+
+    // Loaded from files, plus the ones built while m_KeepTables is set
+    std::map<std::string, std::shared_ptr<const DiscriminatorTables>> m_Tables;
+};
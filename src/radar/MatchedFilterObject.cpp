@@ -0,0 +1,282 @@
+#include "MatchedFilterObject.hpp"
+
+#include "core/StateArchive.hpp"
+#include "signal/SignalGenerator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // Zero picks a size from the replica, anything else has to hold the whole replica so segments advance
+    bool ValidFftSize(int fftSize, size_t taps)
+    {
+        return fftSize == 0 || (fftSize > 0 && static_cast<size_t>(fftSize) >= taps);
+    }
+}
+
+MatchedFilterObject::MatchedFilterObject(std::vector<Complex> replica, int fftSize)
+{
+    SetReplica(std::move(replica), fftSize);
+}
+
+void MatchedFilterObject::SetReplica(std::vector<Complex> replica, int fftSize)
+{
+    if (!ValidFftSize(fftSize, replica.size()))
+    {
+        throw std::invalid_argument("MatchedFilterObject needs an FFT size of at least the replica length");
+    }
+
+    // Keep the newest samples of every channel that fit the new history length
+    const size_t oldHistory = m_Replica.empty() ? 0 : m_Replica.size() - 1;
+    const size_t newHistory = replica.empty() ? 0 : replica.size() - 1;
+    std::vector<Complex> history(Channels * newHistory);
+    const size_t kept = std::min(oldHistory, newHistory);
+    for (int c = 0; c < Channels; c++)
+    {
+        std::copy_n(m_History.begin() + (c + 1) * oldHistory - kept, kept, history.begin() + (c + 1) * newHistory - kept);
+    }
+
+    m_History = std::move(history);
+    m_Replica = std::move(replica);
+    m_RequestedFftSize = fftSize;
+    m_SpectrumDirty = true;
+}
+
+std::vector<Complex> MatchedFilterObject::SampleReplica(const SignalGenerator &generator, double samplePeriod)
+{
+    const double width = generator.getParameters().pulseWidth;
+    if (width <= 0.0 || samplePeriod <= 0.0)
+    {
+        throw std::invalid_argument("MatchedFilterObject needs a pulsed generator and a sample period to sample a replica");
+    }
+
+    const int count = std::max(static_cast<int>(std::ceil(width / samplePeriod)), 1);
+    std::vector<Complex> replica(count);
+    for (int i = 0; i < count; i++)
+    {
+        replica[i] = generator.SampleEnvelope(i * samplePeriod);
+    }
+    return replica;
+}
+
+void MatchedFilterObject::Reset()
+{
+    std::fill(m_History.begin(), m_History.end(), Complex());
+    m_NextSampleIndex = 0;
+    m_TailEnd = 0;
+}
+
+void MatchedFilterObject::BuildSpectrum()
+{
+    const int taps = static_cast<int>(m_Replica.size());
+    m_FftSize = m_RequestedFftSize > 0 ? m_RequestedFftSize : std::max(64, static_cast<int>(std::bit_ceil(4u * static_cast<unsigned>(taps))));
+    m_Forward = Dsp::FftPlan::Get(m_FftSize, Dsp::FftDirection::Forward);
+    m_Inverse = Dsp::FftPlan::Get(m_FftSize, Dsp::FftDirection::Inverse);
+
+    const float scale = 1.0f / static_cast<float>(m_FftSize);
+    m_Spectrum.assign(m_FftSize, Complex());
+    for (int k = 0; k < taps; k++)
+    {
+        m_Spectrum[k] = std::conj(m_Replica[taps - 1 - k]) * scale;
+    }
+    m_Forward->Execute(m_Spectrum.data());
+
+    m_Segments.resize(static_cast<size_t>(Channels) * m_FftSize);
+    m_SpectrumDirty = false;
+}
+
+void MatchedFilterObject::SkipSamples(uint64_t count)
+{
+    const size_t history = m_Replica.size() - 1;
+    const size_t shift = static_cast<size_t>(std::min<uint64_t>(count, history));
+    for (int c = 0; c < Channels; c++)
+    {
+        auto begin = m_History.begin() + c * history;
+        std::copy(begin + shift, begin + history, begin);
+        std::fill(begin + (history - shift), begin + history, Complex());
+    }
+}
+
+void MatchedFilterObject::FilterFft(Complex *const outputs[Channels], int begin, int count, size_t extended)
+{
+    const int size = m_FftSize;
+    const int history = static_cast<int>(m_Replica.size()) - 1;
+    for (int c = 0; c < Channels; c++)
+    {
+        const Complex *source = m_Extended.data() + c * extended + begin;
+        Complex *segment = m_Segments.data() + static_cast<size_t>(c) * size;
+        std::copy_n(source, history + count, segment);
+        std::fill(segment + history + count, segment + size, Complex());
+    }
+
+    // All channels go through the same plans in one call each
+    m_Forward->Execute(m_Segments.data(), Channels);
+
+    const float *spectrum = reinterpret_cast<const float *>(m_Spectrum.data());
+    for (int c = 0; c < Channels; c++)
+    {
+        float *segment = reinterpret_cast<float *>(m_Segments.data() + static_cast<size_t>(c) * size);
+        for (int k = 0; k < size; k++)
+        {
+            const float ar = segment[2 * k], ai = segment[2 * k + 1];
+            const float br = spectrum[2 * k], bi = spectrum[2 * k + 1];
+            segment[2 * k] = ar * br - ai * bi;
+            segment[2 * k + 1] = ar * bi + ai * br;
+        }
+    }
+
+    m_Inverse->Execute(m_Segments.data(), Channels);
+
+    // The first history points of every segment are wrapped around, the rest is the linear correlation
+    for (int c = 0; c < Channels; c++)
+    {
+        std::copy_n(m_Segments.data() + static_cast<size_t>(c) * size + history, count, outputs[c] + begin);
+    }
+}
+
+void MatchedFilterObject::FilterDirect(Complex *const outputs[Channels], int begin, int count, size_t extended)
+{
+    // Tap by tap over all outputs, so the inner loop runs along the samples and vectorizes without reordering sums
+    const int taps = static_cast<int>(m_Replica.size());
+    for (int c = 0; c < Channels; c++)
+    {
+        const float *source = reinterpret_cast<const float *>(m_Extended.data() + c * extended + begin);
+        float *output = reinterpret_cast<float *>(outputs[c] + begin);
+        std::fill_n(output, 2 * count, 0.0f);
+        for (int j = 0; j < taps; j++)
+        {
+            const float br = m_Replica[j].real(), bi = m_Replica[j].imag();
+            const float *x = source + 2 * j;
+            for (int n = 0; n < count; n++)
+            {
+                const float ar = x[2 * n], ai = x[2 * n + 1];
+                output[2 * n] += ar * br + ai * bi;
+                output[2 * n + 1] += ai * br - ar * bi;
+            }
+        }
+    }
+}
+
+void MatchedFilterObject::ProcessBlock(const SimulationBlock &block)
+{
+    const int nSamples = block.nSamples;
+    Complex *const outputs[Channels] = {m_SumOutput.Data(), m_AzimuthOutput.Data(), m_ElevationOutput.Data()};
+    const int taps = static_cast<int>(m_Replica.size());
+    if (taps == 0)
+    {
+        for (Complex *output : outputs)
+        {
+            std::fill_n(output, nSamples, Complex());
+        }
+        return;
+    }
+
+    if (m_SpectrumDirty)
+    {
+        BuildSpectrum();
+    }
+
+    // Samples skipped in event mode were zeros
+    if (block.sampleIndex > m_NextSampleIndex)
+    {
+        SkipSamples(block.sampleIndex - m_NextSampleIndex);
+    }
+    m_NextSampleIndex = block.sampleIndex + nSamples;
+
+    const Complex *inputs[Channels] = {m_SumInput.Data(), m_AzimuthInput.Data(), m_ElevationInput.Data()};
+    for (const Complex *&input : inputs)
+    {
+        if (input == nullptr)
+        {
+            m_Zeros.resize(std::max<size_t>(m_Zeros.size(), nSamples));
+            input = m_Zeros.data();
+        }
+    }
+
+    // Every channel as one contiguous run of its history and the block
+    const size_t history = taps - 1;
+    const size_t extended = history + nSamples;
+    m_Extended.resize(std::max(m_Extended.size(), Channels * extended));
+    int lastActive = -1;
+    for (int c = 0; c < Channels; c++)
+    {
+        Complex *channel = m_Extended.data() + c * extended;
+        std::copy_n(m_History.data() + c * history, history, channel);
+        std::copy_n(inputs[c], nSamples, channel + history);
+
+        for (int i = nSamples - 1; i > lastActive; i--)
+        {
+            if (inputs[c][i] != Complex())
+            {
+                lastActive = i;
+                break;
+            }
+        }
+    }
+    if (lastActive >= 0)
+    {
+        m_TailEnd = block.startTick + static_cast<int64_t>(lastActive + taps) * block.ticksPerSample;
+    }
+
+    // One transform of every channel per segment costs about fftSize (log2(fftSize) + 2) multiply-adds, shorter
+    // segments are cheaper to correlate directly
+    const int segmentLength = m_FftSize - static_cast<int>(history);
+    const int64_t fftCost = static_cast<int64_t>(m_FftSize) * (std::bit_width(static_cast<unsigned>(m_FftSize)) + 1);
+    for (int begin = 0; begin < nSamples; begin += segmentLength)
+    {
+        const int count = std::min(segmentLength, nSamples - begin);
+        if (static_cast<int64_t>(count) * taps <= fftCost)
+        {
+            FilterDirect(outputs, begin, count, extended);
+        }
+        else
+        {
+            FilterFft(outputs, begin, count, extended);
+        }
+    }
+
+    for (int c = 0; c < Channels; c++)
+    {
+        std::copy_n(m_Extended.data() + c * extended + nSamples, history, m_History.data() + c * history);
+    }
+}
+
+ActivityWindow MatchedFilterObject::NextActivity(int64_t tick, double tickPeriod) const
+{
+    if (m_TailEnd > tick)
+    {
+        return {tick, m_TailEnd};
+    }
+    return {ActivityWindow::Never, ActivityWindow::Never};
+}
+
+void MatchedFilterObject::SaveState(StateWriter &writer) const
+{
+    writer.WriteVector(m_Replica);
+    writer.Write(m_RequestedFftSize);
+    writer.WriteVector(m_History);
+    writer.Write(m_NextSampleIndex);
+    writer.Write(m_TailEnd);
+}
+
+void MatchedFilterObject::LoadState(StateReader &reader)
+{
+    reader.ReadVector(m_Replica);
+    reader.Read(m_RequestedFftSize);
+    reader.ReadVector(m_History);
+    reader.Read(m_NextSampleIndex);
+    reader.Read(m_TailEnd);
+
+    if (m_History.size() != (m_Replica.empty() ? 0 : Channels * (m_Replica.size() - 1)))
+    {
+        throw std::runtime_error("MatchedFilterObject state has a history that doesn't match its replica");
+    }
+    if (!ValidFftSize(m_RequestedFftSize, m_Replica.size()))
+    {
+        throw std::runtime_error("MatchedFilterObject state has an FFT size shorter than its replica");
+    }
+    m_SpectrumDirty = true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/AlignedAllocator.hpp"
+#include "core/Port.hpp"
+#include "core/SimulationObject.hpp"
+#include "dsp/Fft.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SignalGenerator;
+
+// Pulse compression of the comparator's "sum", "azimuth" and "elevation" channels. Each channel is correlated
+// with the replica of the transmitted pulse (r[0], ..., r[M - 1]):
+//
+//   y[n] = sum over j of conj(r[j]) x[n - M + 1 + j]
+//
+// so an echo matching the replica peaks at its last sample, with its amplitude times the replica energy.
+//
+// The filter runs as overlap-save fast convolution: segments of fftSize points overlap by M - 1 samples, all
+// three channels of a segment are transformed in one batched FFT, multiplied by the spectrum of the replica
+// (computed once per replica and FFT size) and transformed back. Segments too short for the FFT to pay off (small
+// blocks, the end of a block) are correlated directly. The last M - 1 input samples carry over between blocks,
+// so the result doesn't depend on the block size. Without a replica the outputs are 0.
+class MatchedFilterObject : public SimulationObject
+{
+public:
+    static constexpr int Channels = 3;
+
+    // fftSize 0 picks a power of two of about four replica lengths
+    MatchedFilterObject(std::vector<Complex> replica = {}, int fftSize = 0);
+
+    void Initialize() override {}
+    void Finalize() override {}
+    void Reset() override;
+
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    // Only passes on what the comparator delivers, plus the tail of the last non-zero input
+    ActivityWindow NextActivity(int64_t tick, double tickPeriod) const override;
+
+    void SaveState(StateWriter &writer) const override;
+    void LoadState(StateReader &reader) override;
+
+    // Takes effect on the next block, the filter keeps its input history
+    void SetReplica(std::vector<Complex> replica, int fftSize = 0);
+    const std::vector<Complex> &getReplica() const { return m_Replica; }
+    int getFftSize() const { return m_FftSize; }
+
+    // One pulse of a generator's complex envelope sampled every samplePeriod, starting at time 0
+    static std::vector<Complex> SampleReplica(const SignalGenerator &generator, double samplePeriod);
+
+    InputPort<Complex> &getSum() { return m_SumInput; }
+    InputPort<Complex> &getAzimuth() { return m_AzimuthInput; }
+    InputPort<Complex> &getElevation() { return m_ElevationInput; }
+    OutputPort<Complex> &getSumOutput() { return m_SumOutput; }
+    OutputPort<Complex> &getAzimuthOutput() { return m_AzimuthOutput; }
+    OutputPort<Complex> &getElevationOutput() { return m_ElevationOutput; }
+
+private:
+    // Frequency domain replica and plans for m_FftSize
+    void BuildSpectrum();
+
+    // Moves the history on by samples that were skipped (zeros)
+    void SkipSamples(uint64_t count);
+
+    // Outputs [begin, begin + count) of the block, from m_Extended
+    void FilterFft(Complex *const outputs[Channels], int begin, int count, size_t extended);
+    void FilterDirect(Complex *const outputs[Channels], int begin, int count, size_t extended);
+
+    std::vector<Complex> m_Replica;
+    int m_RequestedFftSize = 0;
+    int m_FftSize = 0;
+    bool m_SpectrumDirty = true;
+
+    // conj(r[M - 1 - k]) / fftSize transformed, so the unnormalized inverse gives the filter output
+    AlignedVector<Complex> m_Spectrum;
+    std::shared_ptr<const Dsp::FftPlan> m_Forward;
+    std::shared_ptr<const Dsp::FftPlan> m_Inverse;
+
+    // Last M - 1 input samples of every channel, m_History[channel * (M - 1) + i]
+    std::vector<Complex> m_History;
+    uint64_t m_NextSampleIndex = 0;
+
+    // Tick at which the output of the last non-zero input has died out, keeps the filter active until then
+    int64_t m_TailEnd = 0;
+
+    // History followed by the block for every channel, and the segments of all channels back to back, grown to the
+    // largest block
+    AlignedVector<Complex> m_Extended;
+    AlignedVector<Complex> m_Segments;
+    std::vector<Complex> m_Zeros;
+
+    InputPort<Complex> m_SumInput{this, "sum"};
+    InputPort<Complex> m_AzimuthInput{this, "azimuth"};
+    InputPort<Complex> m_ElevationInput{this, "elevation"};
+    OutputPort<Complex> m_SumOutput{this, "sum"};
+    OutputPort<Complex> m_AzimuthOutput{this, "azimuth"};
+    OutputPort<Complex> m_ElevationOutput{this, "elevation"};
+};
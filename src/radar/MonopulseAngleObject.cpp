@@ -0,0 +1,29 @@
+#include "MonopulseAngleObject.hpp"
+
+#include <algorithm>
+
+void MonopulseAngleObject::ProcessBlock(const SimulationBlock &block)
+{
+    const int nSamples = block.nSamples;
+    const bool calibrated = m_Calibration.Update();
+
+    const Complex *azimuthRatio = m_AzimuthRatio.Data();
+    if (calibrated && azimuthRatio != nullptr)
+    {
+        m_Calibration.EvaluateAzimuth(azimuthRatio, m_Azimuth.Data(), nSamples);
+    }
+    else
+    {
+        std::fill_n(m_Azimuth.Data(), nSamples, 0.0f);
+    }
+
+    const Complex *elevationRatio = m_ElevationRatio.Data();
+    if (calibrated && elevationRatio != nullptr)
+    {
+        m_Calibration.EvaluateElevation(elevationRatio, m_Elevation.Data(), nSamples);
+    }
+    else
+    {
+        std::fill_n(m_Elevation.Data(), nSamples, 0.0f);
+    }
+}
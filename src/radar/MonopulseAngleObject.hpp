@@ -0,0 +1,41 @@
+#pragma once
+
+#include "core/Port.hpp"
+#include "core/SimulationObject.hpp"
+#include "radar/DiscriminatorCalibration.hpp"
+
+// Off-boresight angles (rad) of every cell from the monopulse ratios of MonopulseRatioObject, looked up in the
+// discriminator calibration of the antenna. The calibration is checked every block and only rebuilt after the
+// antenna changed, e.g. when a sweep retunes its frequency. Without an antenna or ratio the angle is 0.
+class MonopulseAngleObject : public SimulationObject
+{
+public:
+    MonopulseAngleObject(const AntennaPattern *antenna = nullptr, int tableSize = 1024) : m_Calibration(antenna, tableSize) {}
+
+    void Initialize() override { m_Calibration.Update(); }
+    void Finalize() override {}
+    void Reset() override {}
+
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    // Only passes on what the ratio object delivers
+    ActivityWindow NextActivity(int64_t tick, double tickPeriod) const override
+    {
+        return {ActivityWindow::Never, ActivityWindow::Never};
+    }
+
+    DiscriminatorCalibration &getCalibration() { return m_Calibration; }
+
+    InputPort<Complex> &getAzimuthRatio() { return m_AzimuthRatio; }
+    InputPort<Complex> &getElevationRatio() { return m_ElevationRatio; }
+    OutputPort<float> &getAzimuth() { return m_Azimuth; }
+    OutputPort<float> &getElevation() { return m_Elevation; }
+
+private:
+    DiscriminatorCalibration m_Calibration;
+
+    InputPort<Complex> m_AzimuthRatio{this, "azimuthRatio"};
+    InputPort<Complex> m_ElevationRatio{this, "elevationRatio"};
+    OutputPort<float> m_Azimuth{this, "azimuth"};
+    OutputPort<float> m_Elevation{this, "elevation"};
+};
@@ -0,0 +1,22 @@
+#include "MonopulseComparatorObject.hpp"
+
+#include "dsp/Monopulse.hpp"
+
+#include <algorithm>
+
+void MonopulseComparatorObject::ProcessBlock(const SimulationBlock &block)
+{
+    const int nSamples = block.nSamples;
+    const Complex *in = m_Input.Data();
+    if (in == nullptr)
+    {
+        for (OutputPort<Complex> *output : {&m_Sum, &m_Azimuth, &m_Elevation, &m_Quadrature})
+        {
+            std::fill_n(output->Data(), nSamples, Complex());
+        }
+        return;
+    }
+
+    // Every output has its buffer whether it is read or not, writing all four keeps the kernel branch free
+    Dsp::MonopulseButterfly(in, m_Sum.Data(), m_Azimuth.Data(), m_Elevation.Data(), m_Quadrature.Data(), nSamples);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "AntennaPattern.hpp"
+
+#include "core/Port.hpp"
+#include "core/SimulationObject.hpp"
+
+// Forms the monopulse sum and difference channels from the four horn channels A, B, C, D on its "in" port
+// (see AntennaPattern for the horn layout):
+//
+//   sum        A + B + C + D
+//   azimuth    (A + C) - (B + D)
+//   elevation  (A + B) - (C + D)
+//   quadrature (A + D) - (B + C)
+//
+// The horns of a sample are 8 consecutive floats, all four channels come out of two levels of add/sub
+// butterflies on them (Dsp::MonopulseButterfly).
+class MonopulseComparatorObject : public SimulationObject
+{
+public:
+    MonopulseComparatorObject() = default;
+
+    void Initialize() override {}
+    void Finalize() override {}
+    void Reset() override {}
+
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    // Only passes on what the horns deliver
+    ActivityWindow NextActivity(int64_t tick, double tickPeriod) const override
+    {
+        return {ActivityWindow::Never, ActivityWindow::Never};
+    }
+
+    InputPort<Complex> &getInput() { return m_Input; }
+    OutputPort<Complex> &getSum() { return m_Sum; }
+    OutputPort<Complex> &getAzimuth() { return m_Azimuth; }
+    OutputPort<Complex> &getElevation() { return m_Elevation; }
+    OutputPort<Complex> &getQuadrature() { return m_Quadrature; }
+
+private:
+    InputPort<Complex> m_Input{this, "in", AntennaPattern::Horns};
+    OutputPort<Complex> m_Sum{this, "sum"};
+    OutputPort<Complex> m_Azimuth{this, "azimuth"};
+    OutputPort<Complex> m_Elevation{this, "elevation"};
+    OutputPort<Complex> m_Quadrature{this, "quadrature"};
+};
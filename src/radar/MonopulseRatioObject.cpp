@@ -0,0 +1,28 @@
+#include "MonopulseRatioObject.hpp"
+
+#include "dsp/Monopulse.hpp"
+
+#include <algorithm>
+
+void MonopulseRatioObject::ProcessBlock(const SimulationBlock &block)
+{
+    const int nSamples = block.nSamples;
+    const Complex *sum = m_Sum.Data();
+    if (sum == nullptr)
+    {
+        std::fill_n(m_AzimuthRatio.Data(), nSamples, Complex());
+        std::fill_n(m_ElevationRatio.Data(), nSamples, Complex());
+        return;
+    }
+
+    const Complex *azimuth = m_Azimuth.Data();
+    const Complex *elevation = m_Elevation.Data();
+    if (azimuth == nullptr || elevation == nullptr)
+    {
+        m_Zeros.resize(std::max<size_t>(m_Zeros.size(), nSamples));
+        azimuth = azimuth != nullptr ? azimuth : m_Zeros.data();
+        elevation = elevation != nullptr ? elevation : m_Zeros.data();
+    }
+
+    Dsp::MonopulseRatio(sum, azimuth, elevation, m_AzimuthRatio.Data(), m_ElevationRatio.Data(), nSamples);
+}
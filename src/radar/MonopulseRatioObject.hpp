@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/Port.hpp"
+#include "core/SimulationObject.hpp"
+
+#include <vector>
+
+// Normalized monopulse ratio of both axes for every cell (sample) of the block, delta * conj(sum) / |sum|^2 from
+// the comparator's "sum", "azimuth" and "elevation" channels. The real part of the "azimuthRatio" and
+// "elevationRatio" outputs is the monopulse ratio, the imaginary part the quadrature ratio. Both axes are
+// computed in one pass with one reciprocal per cell (Dsp::MonopulseRatio), cells with a zero sum give 0.
+class MonopulseRatioObject : public SimulationObject
+{
+public:
+    MonopulseRatioObject() = default;
+
+    void Initialize() override {}
+    void Finalize() override {}
+    void Reset() override {}
+
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    // Only passes on what the comparator delivers
+    ActivityWindow NextActivity(int64_t tick, double tickPeriod) const override
+    {
+        return {ActivityWindow::Never, ActivityWindow::Never};
+    }
+
+    InputPort<Complex> &getSum() { return m_Sum; }
+    InputPort<Complex> &getAzimuth() { return m_Azimuth; }
+    InputPort<Complex> &getElevation() { return m_Elevation; }
+    OutputPort<Complex> &getAzimuthRatio() { return m_AzimuthRatio; }
+    OutputPort<Complex> &getElevationRatio() { return m_ElevationRatio; }
+
+private:
+    InputPort<Complex> m_Sum{this, "sum"};
+    InputPort<Complex> m_Azimuth{this, "azimuth"};
+    InputPort<Complex> m_Elevation{this, "elevation"};
+    OutputPort<Complex> m_AzimuthRatio{this, "azimuthRatio"};
+    OutputPort<Complex> m_ElevationRatio{this, "elevationRatio"};
+
+    // Stands in for an unconnected difference channel, grown to the largest block
+    std::vector<Complex> m_Zeros;
+};
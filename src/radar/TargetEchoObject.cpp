@@ -0,0 +1,416 @@
+#include "TargetEchoObject.hpp"
+
+#include "core/Clock.hpp"
+#include "core/Constants.hpp"
+#include "core/StateArchive.hpp"
+#include "dsp/SinCos.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // Transmitted runs closer than this many samples are merged into one span
+    constexpr uint64_t SpanMergeGap = 16;
+}
+
+void TargetEchoObject::Reset()
+{
+    std::fill(m_History.begin(), m_History.end(), Complex());
+    m_NextSampleIndex = 0;
+    m_Spans.clear();
+}
+
+void TargetEchoObject::AddTarget(const Target &target)
+{
+    m_Targets.x.push_back(target.position.x);
+    m_Targets.y.push_back(target.position.y);
+    m_Targets.z.push_back(target.position.z);
+    m_Targets.vx.push_back(target.velocity.x);
+    m_Targets.vy.push_back(target.velocity.y);
+    m_Targets.vz.push_back(target.velocity.z);
+    m_Targets.rcs.push_back(target.rcs);
+}
+
+void TargetEchoObject::SetTarget(size_t index, const Target &target)
+{
+    m_Targets.x[index] = target.position.x;
+    m_Targets.y[index] = target.position.y;
+    m_Targets.z[index] = target.position.z;
+    m_Targets.vx[index] = target.velocity.x;
+    m_Targets.vy[index] = target.velocity.y;
+    m_Targets.vz[index] = target.velocity.z;
+    m_Targets.rcs[index] = target.rcs;
+}
+
+Target TargetEchoObject::getTarget(size_t index) const
+{
+    Target target;
+    target.position = {m_Targets.x[index], m_Targets.y[index], m_Targets.z[index]};
+    target.velocity = {m_Targets.vx[index], m_Targets.vy[index], m_Targets.vz[index]};
+    target.rcs = m_Targets.rcs[index];
+    return target;
+}
+
+void TargetEchoObject::ClearTargets()
+{
+    m_Targets = TargetArrays();
+}
+
+void TargetEchoObject::setAntennaPattern(const AntennaPattern *antenna)
+{
+    if (antenna != nullptr && m_Output.getChannels() != AntennaPattern::Horns)
+    {
+        throw std::invalid_argument("TargetEchoObject needs one channel per horn to use an antenna pattern");
+    }
+    p_Antenna = antenna;
+    m_Gains.clear();
+}
+
+void TargetEchoObject::ChannelGains(double time)
+{
+    const size_t count = getTargetCount();
+    m_Azimuth.resize(count);
+    m_Elevation.resize(count);
+    m_Gains.resize(count * AntennaPattern::Horns);
+
+    // Look direction of every target from the radar, boresight is +x
+    const Position &radar = m_Settings.radarPosition;
+    for (size_t i = 0; i < count; i++)
+    {
+        const double dx = m_Targets.x[i] + m_Targets.vx[i] * time - radar.x;
+        const double dy = m_Targets.y[i] + m_Targets.vy[i] * time - radar.y;
+        const double dz = m_Targets.z[i] + m_Targets.vz[i] * time - radar.z;
+        m_Azimuth[i] = static_cast<float>(std::atan2(dy, dx));
+        m_Elevation[i] = static_cast<float>(std::atan2(dz, std::sqrt(dx * dx + dy * dy)));
+    }
+
+    p_Antenna->Evaluate(m_Azimuth.data(), m_Elevation.data(), m_Gains.data(), static_cast<int>(count));
+    for (size_t i = 0; i < count; i++)
+    {
+        Complex *gains = &m_Gains[i * AntennaPattern::Horns];
+        const Complex transmit = 0.5f * (gains[0] + gains[1] + gains[2] + gains[3]);
+        for (int horn = 0; horn < AntennaPattern::Horns; horn++)
+        {
+            gains[horn] *= transmit;
+        }
+    }
+}
+
+void TargetEchoObject::Ranges(double time, double *ranges) const
+{
+    const size_t count = getTargetCount();
+    const double *x = m_Targets.x.data();
+    const double *y = m_Targets.y.data();
+    const double *z = m_Targets.z.data();
+    const double *vx = m_Targets.vx.data();
+    const double *vy = m_Targets.vy.data();
+    const double *vz = m_Targets.vz.data();
+    const Position &radar = m_Settings.radarPosition;
+    for (size_t i = 0; i < count; i++)
+    {
+        const double dx = x[i] + vx[i] * time - radar.x;
+        const double dy = y[i] + vy[i] * time - radar.y;
+        const double dz = z[i] + vz[i] * time - radar.z;
+        ranges[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+void TargetEchoObject::ReserveHistory(size_t frames)
+{
+    const size_t capacity = m_HistoryMask + 1;
+    if (!m_History.empty() && capacity >= frames)
+    {
+        return;
+    }
+
+    const size_t newCapacity = std::bit_ceil(std::max<size_t>(frames, 1024));
+    std::vector<Complex> history(2 * newCapacity, Complex());
+    const uint64_t newMask = newCapacity - 1;
+    if (!m_History.empty())
+    {
+        const uint64_t kept = std::min<uint64_t>(m_NextSampleIndex, capacity);
+        for (uint64_t index = m_NextSampleIndex - kept; index < m_NextSampleIndex; index++)
+        {
+            const Complex value = m_History[index & m_HistoryMask];
+            history[index & newMask] = value;
+            history[(index & newMask) + newCapacity] = value;
+        }
+    }
+    m_History.swap(history);
+    m_HistoryMask = newMask;
+}
+
+void TargetEchoObject::RecordTransmit(const SimulationBlock &block)
+{
+    const uint64_t capacity = m_HistoryMask + 1;
+    Complex *history = m_History.data();
+
+    // Samples skipped by the discrete-event mode were never transmitted
+    if (block.sampleIndex > m_NextSampleIndex)
+    {
+        const uint64_t gap = std::min<uint64_t>(block.sampleIndex - m_NextSampleIndex, capacity);
+        for (uint64_t index = block.sampleIndex - gap; index < block.sampleIndex; index++)
+        {
+            history[index & m_HistoryMask] = Complex();
+            history[(index & m_HistoryMask) + capacity] = Complex();
+        }
+    }
+
+    const Complex *in = m_Input.Data();
+    for (int i = 0; i < block.nSamples; i++)
+    {
+        const uint64_t index = block.sampleIndex + i;
+        const Complex value = in != nullptr ? in[i] : Complex();
+        history[index & m_HistoryMask] = value;
+        history[(index & m_HistoryMask) + capacity] = value;
+
+        if (value != Complex())
+        {
+            if (!m_Spans.empty() && index <= m_Spans.back().end + SpanMergeGap)
+            {
+                m_Spans.back().end = index + 1;
+            }
+            else
+            {
+                m_Spans.push_back({index, index + 1});
+            }
+        }
+    }
+    m_NextSampleIndex = block.sampleIndex + block.nSamples;
+}
+
+void TargetEchoObject::ProcessBlock(const SimulationBlock &block)
+{
+    const int channels = m_Output.getChannels();
+    const int nSamples = block.nSamples;
+    const double c = Constants::SpeedOfLight;
+    const double maxDelay = 2 * m_Settings.maxRange / c / block.dt;
+
+    ReserveHistory(static_cast<size_t>(std::ceil(maxDelay)) + nSamples + 2);
+    RecordTransmit(block);
+    m_TickAtSampleZero = block.startTick - static_cast<int64_t>(block.sampleIndex) * block.ticksPerSample;
+    m_TicksPerSample = block.ticksPerSample;
+
+    // Spans whose echoes have all arrived are dropped
+    const uint64_t horizon = static_cast<uint64_t>(std::ceil(maxDelay)) + 2;
+    auto expired = std::find_if(m_Spans.begin(), m_Spans.end(), [&](const Span &span) { return span.end + horizon > block.sampleIndex; });
+    m_Spans.erase(m_Spans.begin(), expired);
+
+    std::fill_n(m_Output.Data(), static_cast<size_t>(nSamples) * channels, Complex());
+    const size_t targetCount = getTargetCount();
+    if (m_Spans.empty() || targetCount == 0)
+    {
+        return;
+    }
+
+    // Geometry of every target at both ends of the block, the delay is linear in between
+    m_Range0.resize(targetCount);
+    m_Range1.resize(targetCount);
+    m_Delay.resize(targetCount);
+    m_DelayRate.resize(targetCount);
+    m_Amplitude.resize(targetCount);
+    Ranges(block.t0, m_Range0.data());
+    Ranges(block.t0 + nSamples * block.dt, m_Range1.data());
+
+    const double lambda = c / m_Settings.carrierFrequency;
+    const double scale = lambda / std::pow(4 * Constants::PI, 1.5);
+    for (size_t i = 0; i < targetCount; i++)
+    {
+        const double delay0 = 2 * m_Range0[i] / c / block.dt;
+        const double delay1 = 2 * m_Range1[i] / c / block.dt;
+        m_Delay[i] = delay0;
+        m_DelayRate[i] = (delay1 - delay0) / nSamples;
+
+        const bool synthesized = std::min(delay0, delay1) >= 1.0 && std::max(delay0, delay1) <= maxDelay;
+        m_Amplitude[i] = synthesized ? static_cast<float>(scale * std::sqrt(m_Targets.rcs[i]) / (m_Range0[i] * m_Range0[i])) : 0.0f;
+    }
+
+    if (p_Antenna != nullptr)
+    {
+        ChannelGains(block.t0);
+    }
+
+    m_Echo.resize(std::max<size_t>(m_Echo.size(), nSamples));
+    m_Sin.resize(std::max<size_t>(m_Sin.size(), nSamples));
+    m_Cos.resize(std::max<size_t>(m_Cos.size(), nSamples));
+
+    for (size_t target = 0; target < targetCount; target++)
+    {
+        if (m_Amplitude[target] == 0.0f)
+        {
+            continue;
+        }
+
+        // Samples of the block whose delayed time falls in a transmitted span, ranges are kept disjoint so
+        // nearby spans don't add the same samples twice
+        const double delayLow = std::min(m_Delay[target], m_Delay[target] + m_DelayRate[target] * nSamples);
+        const double delayHigh = std::max(m_Delay[target], m_Delay[target] + m_DelayRate[target] * nSamples);
+        int done = 0;
+        for (const Span &span : m_Spans)
+        {
+            const double spanBegin = static_cast<double>(static_cast<int64_t>(span.begin - block.sampleIndex));
+            const double spanEnd = static_cast<double>(static_cast<int64_t>(span.end - block.sampleIndex));
+            const int begin = static_cast<int>(std::clamp(std::floor(spanBegin - 1 + delayLow), static_cast<double>(done), static_cast<double>(nSamples)));
+            const int end = static_cast<int>(std::clamp(std::ceil(spanEnd + delayHigh) + 1, static_cast<double>(begin), static_cast<double>(nSamples)));
+            if (end > begin)
+            {
+                SynthesizeEcho(block, target, begin, end);
+                done = end;
+            }
+        }
+    }
+}
+
+void TargetEchoObject::SynthesizeEcho(const SimulationBlock &block, size_t target, int begin, int end)
+{
+    const int count = end - begin;
+    const double delay = m_Delay[target];
+    const double delayRate = m_DelayRate[target];
+    const float amplitude = m_Amplitude[target];
+
+    // Sample n reads the history at base + n - (fraction + n * delayRate), the window starts one sample early
+    // so the interpolation never reads before it
+    const double whole = std::floor(delay);
+    const float fraction = static_cast<float>(delay - whole);
+    const float rate = static_cast<float>(delayRate);
+    const int64_t base = static_cast<int64_t>(block.sampleIndex) - static_cast<int64_t>(whole);
+    const int first = static_cast<int>(std::floor(begin - fraction - begin * rate)) - 1;
+    const Complex *history = m_History.data() + (static_cast<uint64_t>(base + first) & m_HistoryMask);
+
+    Complex *echo = m_Echo.data();
+    for (int i = 0; i < count; i++)
+    {
+        const int n = begin + i;
+        const float position = static_cast<float>(n - first) - (fraction + static_cast<float>(n) * rate);
+        const int index = static_cast<int>(position);
+        const float weight = position - static_cast<float>(index);
+        echo[i] = history[index] + weight * (history[index + 1] - history[index]);
+    }
+
+    // Carrier phase -fc tau, linear over the block like the delay
+    const double samplePeriod = block.dt;
+    const uint64_t phase = Clock::PhaseIncrement(-m_Settings.carrierFrequency, (delay + begin * delayRate) * samplePeriod);
+    const uint64_t increment = Clock::PhaseIncrement(-m_Settings.carrierFrequency, delayRate * samplePeriod);
+    Dsp::SinCos(phase, increment, m_Sin.data(), m_Cos.data(), count);
+
+    const int channels = m_Output.getChannels();
+    Complex *out = m_Output.Data() + static_cast<size_t>(begin) * channels;
+    if (p_Antenna == nullptr)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            const Complex value = amplitude * echo[i] * Complex(m_Cos[i], m_Sin[i]);
+            for (int channel = 0; channel < channels; channel++)
+            {
+                out[i * channels + channel] += value;
+            }
+        }
+        return;
+    }
+
+    const Complex *gains = &m_Gains[target * channels];
+    for (int i = 0; i < count; i++)
+    {
+        const Complex value = amplitude * echo[i] * Complex(m_Cos[i], m_Sin[i]);
+        for (int channel = 0; channel < channels; channel++)
+        {
+            out[i * channels + channel] += gains[channel] * value;
+        }
+    }
+}
+
+ActivityWindow TargetEchoObject::NextActivity(int64_t tick, double tickPeriod) const
+{
+    const size_t targetCount = getTargetCount();
+    if (m_Spans.empty() || targetCount == 0 || m_TicksPerSample == 0)
+    {
+        return {ActivityWindow::Never, ActivityWindow::Never};
+    }
+
+    // Delays of the targets in range now, widened by how far they can move before the last echo arrives. Called
+    // every block in discrete-event mode, so the ranges are reduced on the fly instead of stored.
+    const double time = static_cast<double>(tick) * tickPeriod;
+    const Position &radar = m_Settings.radarPosition;
+    double rangeLow = m_Settings.maxRange;
+    double rangeHigh = 0.0;
+    double speed = 0.0;
+    for (size_t i = 0; i < targetCount; i++)
+    {
+        const double dx = m_Targets.x[i] + m_Targets.vx[i] * time - radar.x;
+        const double dy = m_Targets.y[i] + m_Targets.vy[i] * time - radar.y;
+        const double dz = m_Targets.z[i] + m_Targets.vz[i] * time - radar.z;
+        const double range = std::sqrt(dx * dx + dy * dy + dz * dz);
+        rangeLow = std::min(rangeLow, range);
+        rangeHigh = std::max(rangeHigh, std::min(range, m_Settings.maxRange));
+        speed = std::max(speed, std::sqrt(m_Targets.vx[i] * m_Targets.vx[i] + m_Targets.vy[i] * m_Targets.vy[i] + m_Targets.vz[i] * m_Targets.vz[i]));
+    }
+    const double c = Constants::SpeedOfLight;
+    const double samplePeriod = static_cast<double>(m_TicksPerSample) * tickPeriod;
+    const double motion = 2 * speed * (2 * m_Settings.maxRange / c) / c;
+    const int64_t delayLow = static_cast<int64_t>(std::max(2 * rangeLow / c - motion - 2 * samplePeriod, 0.0) / tickPeriod);
+    const int64_t delayHigh = static_cast<int64_t>(std::ceil((2 * rangeHigh / c + motion + 2 * samplePeriod) / tickPeriod));
+
+    for (const Span &span : m_Spans)
+    {
+        const int64_t begin = m_TickAtSampleZero + static_cast<int64_t>(span.begin) * m_TicksPerSample + delayLow;
+        const int64_t end = m_TickAtSampleZero + static_cast<int64_t>(span.end) * m_TicksPerSample + delayHigh;
+        if (end > tick)
+        {
+            return {std::max(begin, tick), end};
+        }
+    }
+    return {ActivityWindow::Never, ActivityWindow::Never};
+}
+
+void TargetEchoObject::SaveState(StateWriter &writer) const
+{
+    writer.WriteVector(m_Targets.x);
+    writer.WriteVector(m_Targets.y);
+    writer.WriteVector(m_Targets.z);
+    writer.WriteVector(m_Targets.vx);
+    writer.WriteVector(m_Targets.vy);
+    writer.WriteVector(m_Targets.vz);
+    writer.WriteVector(m_Targets.rcs);
+    writer.WriteVector(m_History);
+    writer.Write(m_HistoryMask);
+    writer.Write(m_NextSampleIndex);
+    writer.WriteVector(m_Spans);
+    writer.Write(m_TickAtSampleZero);
+    writer.Write(m_TicksPerSample);
+}
+
+void TargetEchoObject::LoadState(StateReader &reader)
+{
+    reader.ReadVector(m_Targets.x);
+    reader.ReadVector(m_Targets.y);
+    reader.ReadVector(m_Targets.z);
+    reader.ReadVector(m_Targets.vx);
+    reader.ReadVector(m_Targets.vy);
+    reader.ReadVector(m_Targets.vz);
+    reader.ReadVector(m_Targets.rcs);
+    reader.ReadVector(m_History);
+    reader.Read(m_HistoryMask);
+    reader.Read(m_NextSampleIndex);
+    reader.ReadVector(m_Spans);
+    reader.Read(m_TickAtSampleZero);
+    reader.Read(m_TicksPerSample);
+
+    const size_t count = m_Targets.x.size();
+    for (const std::vector<double> *values : {&m_Targets.y, &m_Targets.z, &m_Targets.vx, &m_Targets.vy, &m_Targets.vz, &m_Targets.rcs})
+    {
+        if (values->size() != count)
+        {
+            throw std::runtime_error("TargetEchoObject state has target arrays of different lengths");
+        }
+    }
+
+    // The history is empty before the first block, otherwise two copies of a power of two capacity
+    const uint64_t capacity = m_HistoryMask + 1;
+    if (!m_History.empty() && (capacity == 0 || !std::has_single_bit(capacity) || m_History.size() != 2 * capacity))
+    {
+        throw std::runtime_error("TargetEchoObject state has a history that doesn't match its capacity");
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "AntennaPattern.hpp"
+
+#include "core/Environment.hpp"
+#include "core/Port.hpp"
+#include "core/SimulationObject.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Point target, position at time 0 moving at a constant velocity
+struct Target
+{
+    Position position;
+    Velocity velocity;
+    double rcs = 1.0; // m^2, radar cross section
+};
+
+struct TargetEchoSettings
+{
+    double carrierFrequency = 10e9; // Hz, carrier of the transmitted envelope
+    double maxRange = 30e3;         // m, returns from farther targets are not synthesized
+    Position radarPosition;
+    int channels = 4; // One per receive horn
+};
+
+// Returns of point targets for the complex envelope transmitted on the "tx" port. Every channel of the "out"
+// port receives the sum over targets of
+//
+//   amplitude * tx(t - tau(t)) * e^(-j 2 PI fc tau(t)),   tau(t) = 2 |p(t) - radar| / c
+//
+// where the amplitude follows the radar equation for isotropic antennas, lambda sqrt(rcs) / ((4 PI)^1.5 R^2).
+// With an AntennaPattern set, channel k is also weighted by the gain of horn k towards the target, and the
+// transmission by the sum beam (A + B + C + D) / 2. The gains are taken at the start of each block.
+// The changing delay gives the Doppler shift, it is linearized over each block and the transmitted signal is
+// linearly interpolated at the fractional delay. Targets closer than one sample are not synthesized.
+//
+// Targets are stored as structure of arrays and the geometry of all of them is evaluated in one pass per block.
+// Only the parts of the block that can hold echoes of non-zero transmitted samples are synthesized, so the cost
+// of a pulsed waveform scales with its duty cycle.
+class TargetEchoObject : public SimulationObject
+{
+public:
+    TargetEchoObject(const TargetEchoSettings &settings = TargetEchoSettings())
+        : m_Settings(settings), m_Output(this, "out", settings.channels) {}
+
+    void Initialize() override {}
+    void Finalize() override {}
+    void Reset() override;
+
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    // Active while echoes of already transmitted samples are still arriving
+    ActivityWindow NextActivity(int64_t tick, double tickPeriod) const override;
+
+    void SaveState(StateWriter &writer) const override;
+    void LoadState(StateReader &reader) override;
+
+    void AddTarget(const Target &target);
+    void SetTarget(size_t index, const Target &target);
+    Target getTarget(size_t index) const;
+    void ClearTargets();
+    size_t getTargetCount() const { return m_Targets.x.size(); }
+
+    const TargetEchoSettings &getSettings() const { return m_Settings; }
+
+    // Horn gains applied to the four channels, nullptr for isotropic channels. The pattern must outlive the object.
+    void setAntennaPattern(const AntennaPattern *antenna);
+    const AntennaPattern *getAntennaPattern() const { return p_Antenna; }
+
+    InputPort<Complex> &getInput() { return m_Input; }
+    OutputPort<Complex> &getOutput() { return m_Output; }
+
+private:
+    struct TargetArrays
+    {
+        std::vector<double> x, y, z;
+        std::vector<double> vx, vy, vz;
+        std::vector<double> rcs;
+    };
+
+    // Run of transmitted samples [begin, end) that are not all zero, in sample indices
+    struct Span
+    {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    // Range of every target at a time
+    void Ranges(double time, double *ranges) const;
+
+    // Gains of every channel towards every target at a time, m_Gains[target * channels + channel]
+    void ChannelGains(double time);
+
+    // Grows the history to hold at least frames samples, keeping the newest ones
+    void ReserveHistory(size_t frames);
+
+    // Appends the transmitted block to the history and records where it is non-zero
+    void RecordTransmit(const SimulationBlock &block);
+
+    // Adds the echo of one target over samples [begin, end) of the block to every channel
+    void SynthesizeEcho(const SimulationBlock &block, size_t target, int begin, int end);
+
+    TargetEchoSettings m_Settings;
+    TargetArrays m_Targets;
+    const AntennaPattern *p_Antenna = nullptr;
+
+    // Per target geometry of the current block
+    std::vector<double> m_Range0;
+    std::vector<double> m_Range1;
+    std::vector<double> m_Delay;     // samples, at the first sample of the block
+    std::vector<double> m_DelayRate; // samples of delay per sample
+    std::vector<float> m_Amplitude;  // 0 for targets that are not synthesized
+    std::vector<float> m_Azimuth;    // rad
+    std::vector<float> m_Elevation;  // rad
+    std::vector<Complex> m_Gains;    // Empty without an antenna pattern
+
+    // Transmitted samples, stored twice (at i and i + capacity) so any window up to the capacity is contiguous
+    std::vector<Complex> m_History;
+    uint64_t m_HistoryMask = 0;
+    uint64_t m_NextSampleIndex = 0;
+    std::vector<Span> m_Spans;
+
+    // Sample index to tick mapping of the last block, used to place pending echoes in time
+    int64_t m_TickAtSampleZero = 0;
+    int64_t m_TicksPerSample = 0;
+
+    // Scratch of one target's echo, grown to the largest block
+    std::vector<Complex> m_Echo;
+    std::vector<float> m_Sin;
+    std::vector<float> m_Cos;
+
+    InputPort<Complex> m_Input{this, "tx"};
+    OutputPort<Complex> m_Output;
+};
@@ -0,0 +1,214 @@
+#include "ChirpSignalGenerator.hpp"
+
+#include "core/Clock.hpp"
+#include "core/Constants.hpp"
+#include "core/TableCache.hpp"
+#include "dsp/SinCos.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    double Window(ChirpWindow window, double fraction)
+    {
+        switch (window)
+        {
+        case ChirpWindow::Hann:
+            return 0.5 - 0.5 * std::cos(2 * Constants::PI * fraction);
+        case ChirpWindow::Hamming:
+            return 0.54 - 0.46 * std::cos(2 * Constants::PI * fraction);
+        default:
+            return 1.0;
+        }
+    }
+
+    // Ticks since the start of the pulse repetition interval containing tick
+    int64_t PulseOffset(int64_t tick, int64_t interval)
+    {
+        const int64_t offset = tick % interval;
+        return offset < 0 ? offset + interval : offset;
+    }
+}
+
+Complex ChirpSignalGenerator::PulseEnvelope(double time, double amplitude, double phase) const
+{
+    // Instantaneous frequency f0 + k t relative to the carrier, sweeping the bandwidth over the pulse
+    const double width = m_Parameters.pulseWidth;
+    const double startFrequency = m_Parameters.frequency - m_Parameters.carrierFrequency - 0.5 * m_Settings.bandwidth;
+    const double rate = m_Settings.bandwidth / width;
+    const double theta = 2 * Constants::PI * (startFrequency * time + 0.5 * rate * time * time) + phase;
+    const double magnitude = amplitude * Window(m_Settings.window, time / width);
+    return {static_cast<float>(magnitude * std::sin(theta)), static_cast<float>(-magnitude * std::cos(theta))};
+}
+
+void ChirpSignalGenerator::PulseTicks(double tickPeriod, int64_t &interval, int64_t &width) const
+{
+    width = std::max<int64_t>(Clock::TimeToTicks(m_Parameters.pulseWidth, tickPeriod), 0);
+    interval = width;
+    if (m_Parameters.pulseRepetitionInterval > 0.0)
+    {
+        interval = std::max<int64_t>(Clock::TimeToTicks(m_Parameters.pulseRepetitionInterval, tickPeriod), 1);
+        width = std::min(width, interval);
+    }
+}
+
+Complex ChirpSignalGenerator::SampleEnvelope(double time) const
+{
+    const double width = m_Parameters.pulseWidth;
+    if (width <= 0.0)
+    {
+        return {};
+    }
+
+    const double interval = m_Parameters.pulseRepetitionInterval > 0.0 ? m_Parameters.pulseRepetitionInterval : width;
+    double offset = std::fmod(time, interval);
+    if (offset < 0.0)
+    {
+        offset += interval;
+    }
+    return offset < width ? PulseEnvelope(offset, m_Parameters.amplitude, m_Parameters.phase) : Complex();
+}
+
+double ChirpSignalGenerator::Sample(double time) const
+{
+    const Complex envelope = SampleEnvelope(time);
+    const double carrier = 2 * Constants::PI * m_Parameters.carrierFrequency * time;
+    return envelope.real() * std::cos(carrier) - envelope.imag() * std::sin(carrier) + m_Parameters.offset;
+}
+
+const ChirpSignalGenerator::Waveform &ChirpSignalGenerator::GetWaveform(const SimulationBlock &block, int64_t firstSampleTick)
+{
+    int64_t interval;
+    int64_t width;
+    PulseTicks(block.tickPeriod, interval, width);
+
+    WaveformKey key;
+    key.offsetFrequency = m_Parameters.frequency - m_Parameters.carrierFrequency;
+    key.bandwidth = m_Settings.bandwidth;
+    key.window = m_Settings.window;
+    key.widthTicks = width;
+    key.ticksPerSample = block.ticksPerSample;
+    key.firstSampleTick = firstSampleTick;
+    key.tickPeriod = block.tickPeriod;
+
+    // Only a change of the parameters or of where the sample grid falls within the pulse needs another waveform
+    if (m_Waveform && key == m_WaveformKey)
+    {
+        return *m_Waveform;
+    }
+
+    char name[256];
+    std::snprintf(name, sizeof(name), "chirp.%.17g.%.17g.%d.%lld.%lld.%lld.%.17g", key.offsetFrequency, key.bandwidth, static_cast<int>(key.window), static_cast<long long>(key.widthTicks),
+                  static_cast<long long>(key.ticksPerSample), static_cast<long long>(key.firstSampleTick), key.tickPeriod);
+
+    m_Waveform = TableCache::Shared().GetOrBuild<Waveform>(name, [this, &key]()
+    {
+        // Samples of the pulse at firstSampleTick, firstSampleTick + ticksPerSample, ... before its end
+        const int64_t count = key.widthTicks > key.firstSampleTick
+                                  ? (key.widthTicks - key.firstSampleTick + key.ticksPerSample - 1) / key.ticksPerSample
+                                  : 0;
+        Waveform waveform(static_cast<size_t>(count));
+        for (int64_t n = 0; n < count; n++)
+        {
+            waveform[n] = PulseEnvelope(static_cast<double>(key.firstSampleTick + n * key.ticksPerSample) * key.tickPeriod, 1.0, 0.0);
+        }
+        return waveform;
+    });
+    m_WaveformKey = key;
+    return *m_Waveform;
+}
+
+void ChirpSignalGenerator::ProcessBlock(const SimulationBlock &block)
+{
+    const bool realConnected = m_Output.isConnected();
+    const bool complexConnected = m_ComplexOutput.isConnected();
+    if (!realConnected && !complexConnected)
+    {
+        return;
+    }
+
+    // The real output is the envelope mixed up to the carrier, so both are built from the same envelope
+    Complex *envelope = m_ComplexOutput.Data();
+    if (!complexConnected)
+    {
+        m_Envelope.resize(std::max<size_t>(m_Envelope.size(), block.nSamples));
+        envelope = m_Envelope.data();
+    }
+
+    int64_t interval;
+    int64_t width;
+    PulseTicks(block.tickPeriod, interval, width);
+
+    // The cached pulse has unit amplitude and zero phase, both are applied as one complex gain while copying
+    const float gainRe = static_cast<float>(m_Parameters.amplitude * std::cos(m_Parameters.phase));
+    const float gainIm = static_cast<float>(m_Parameters.amplitude * std::sin(m_Parameters.phase));
+
+    // Walk the block a pulse or a gap at a time, pulses are copied from the cached waveform and gaps are zeroed
+    int i = 0;
+    while (i < block.nSamples)
+    {
+        const int64_t tick = block.startTick + static_cast<int64_t>(i) * block.ticksPerSample;
+        const int64_t offset = width > 0 ? PulseOffset(tick, interval) : interval;
+        int count;
+        if (offset < width && interval % block.ticksPerSample != 0)
+        {
+            // The sample grid lands differently in every pulse, caching each alignment would grow without bound
+            const int64_t remaining = (width - offset + block.ticksPerSample - 1) / block.ticksPerSample;
+            count = static_cast<int>(std::min<int64_t>(block.nSamples - i, remaining));
+            for (int n = 0; n < count; n++)
+            {
+                envelope[i + n] = PulseEnvelope(static_cast<double>(offset + n * block.ticksPerSample) * block.tickPeriod, m_Parameters.amplitude,
+                                                m_Parameters.phase);
+            }
+        }
+        else if (offset < width)
+        {
+            // Every pulse lines up with the same waveform since the interval is a whole number of samples
+            const int64_t firstSampleTick = offset % block.ticksPerSample;
+            const Waveform &waveform = GetWaveform(block, firstSampleTick);
+            const int64_t index = offset / block.ticksPerSample;
+            count = static_cast<int>(std::min<int64_t>(block.nSamples - i, static_cast<int64_t>(waveform.size()) - index));
+            const Complex *source = waveform.data() + index;
+            for (int n = 0; n < count; n++)
+            {
+                const float re = source[n].real(), im = source[n].imag();
+                envelope[i + n] = Complex(re * gainRe - im * gainIm, re * gainIm + im * gainRe);
+            }
+        }
+        else
+        {
+            const int64_t gap = width > 0 ? (interval - offset + block.ticksPerSample - 1) / block.ticksPerSample : block.nSamples;
+            count = static_cast<int>(std::min<int64_t>(block.nSamples - i, gap));
+            std::fill_n(envelope + i, count, Complex());
+        }
+        i += count;
+    }
+
+    if (realConnected)
+    {
+        // Re{(I + jQ) (cos + j sin)} with the carrier phase taken exactly from the tick clock
+        const float offset = static_cast<float>(m_Parameters.offset);
+        float *out = m_Output.Data();
+        if (m_Parameters.carrierFrequency == 0.0)
+        {
+            for (int n = 0; n < block.nSamples; n++)
+            {
+                out[n] = envelope[n].real() + offset;
+            }
+            return;
+        }
+
+        m_Sin.resize(std::max<size_t>(m_Sin.size(), block.nSamples));
+        m_Cos.resize(std::max<size_t>(m_Cos.size(), block.nSamples));
+        const uint64_t startPhase = Clock::PhaseAtTick(m_Parameters.carrierFrequency, block.tickPeriod, block.startTick);
+        const uint64_t phasePerSample = Clock::PhaseIncrement(m_Parameters.carrierFrequency, block.dt);
+        Dsp::SinCos(startPhase, phasePerSample, m_Sin.data(), m_Cos.data(), block.nSamples);
+        for (int n = 0; n < block.nSamples; n++)
+        {
+            out[n] = envelope[n].real() * m_Cos[n] - envelope[n].imag() * m_Sin[n] + offset;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "SignalGenerator.hpp"
+
+#include "core/AlignedAllocator.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+enum class ChirpWindow
+{
+    Rectangular,
+    Hann,
+    Hamming,
+};
+
+struct ChirpSettings
+{
+    double bandwidth = 1e6; // Hz, swept linearly across the pulse, centered on frequency
+    ChirpWindow window = ChirpWindow::Rectangular;
+};
+
+// Pulse train of linear FM chirps. Each pulse lasts pulseWidth and starts every pulseRepetitionInterval (back to
+// back if the interval is 0), its envelope sweeps from frequency - bandwidth / 2 to frequency + bandwidth / 2
+// relative to carrierFrequency. One pulse of unit amplitude and zero phase is precomputed per sweep and sample
+// grid, pulses are emitted by copying it scaled by amplitude and phase and the gaps are filled with zeros. Changing
+// the amplitude or phase never rebuilds the waveform, changing the sweep rebuilds it on the next block.
+// Generators with the same sweep share it through TableCache.
+class ChirpSignalGenerator : public SignalGenerator
+{
+public:
+    ChirpSignalGenerator(const SignalParameters &parameters, const ChirpSettings &settings = ChirpSettings())
+        : SignalGenerator(parameters), m_Settings(settings) {}
+
+    double Sample(double time) const override;
+    Complex SampleEnvelope(double time) const override;
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    const ChirpSettings &getSettings() const { return m_Settings; }
+    void SetSettings(const ChirpSettings &settings) { m_Settings = settings; }
+
+private:
+    // Everything the cached pulse depends on, compared every block to notice parameter changes
+    struct WaveformKey
+    {
+        double offsetFrequency = 0.0;
+        double bandwidth = 0.0;
+        ChirpWindow window = ChirpWindow::Rectangular;
+        int64_t widthTicks = 0;
+        int64_t ticksPerSample = 0;
+        int64_t firstSampleTick = 0; // Tick of the first sample within the pulse
+        double tickPeriod = 0.0;
+
+        bool operator==(const WaveformKey &) const = default;
+    };
+
+    using Waveform = AlignedVector<Complex>;
+
+    // Envelope at a time since the start of the pulse
+    Complex PulseEnvelope(double time, double amplitude, double phase) const;
+
+    // Pulse repetition interval and width in ticks, the interval equals the width for back to back pulses
+    void PulseTicks(double tickPeriod, int64_t &interval, int64_t &width) const;
+
+    const Waveform &GetWaveform(const SimulationBlock &block, int64_t firstSampleTick);
+
+    ChirpSettings m_Settings;
+    WaveformKey m_WaveformKey;
+    std::shared_ptr<const Waveform> m_Waveform;
+
+    // Scratch for mixing the envelope up to the carrier on the real output, grown to the largest block
+    std::vector<Complex> m_Envelope;
+    std::vector<float> m_Sin;
+    std::vector<float> m_Cos;
+};
@@ -0,0 +1,186 @@
+#include "NcoSignalGenerator.hpp"
+
+#include "core/Clock.hpp"
+#include "core/Constants.hpp"
+#include "core/TableCache.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+NcoSignalGenerator::NcoSignalGenerator(const SignalParameters &parameters, const NcoSettings &settings)
+    : SignalGenerator(parameters), m_Settings(settings)
+{
+    if (m_Settings.phaseBits != 32 && m_Settings.phaseBits != 64)
+    {
+        throw std::invalid_argument("NcoSignalGenerator phase accumulator must be 32 or 64 bits wide");
+    }
+    if (m_Settings.tableBits < 2 || m_Settings.tableBits > 24 || m_Settings.tableBits > m_Settings.phaseBits)
+    {
+        throw std::invalid_argument("NcoSignalGenerator table must have between 2^2 and 2^24 entries");
+    }
+
+    const int tableBits = m_Settings.tableBits;
+    m_Table = TableCache::Shared().GetOrBuild<std::vector<float>>("nco.sine." + std::to_string(tableBits), [tableBits]()
+    {
+        const size_t size = size_t(1) << tableBits;
+        std::vector<float> table(size + 1);
+        for (size_t i = 0; i < size; i++)
+        {
+            table[i] = static_cast<float>(std::sin(2 * Constants::PI * static_cast<double>(i) / static_cast<double>(size)));
+        }
+        table[size] = table[0];
+        return table;
+    });
+}
+
+namespace
+{
+    // Sine of a fixed point phase through a table of 2^tableBits entries plus a guard entry
+    template <NcoCorrection Correction>
+    inline float LookupSine(const float *table, int tableBits, uint64_t phase)
+    {
+        const uint64_t index = phase >> (64 - tableBits);
+        if constexpr (Correction == NcoCorrection::None)
+        {
+            return table[index];
+        }
+
+        // Top 24 bits below the index, the fraction of the way to the next entry
+        const float fraction = static_cast<float>((phase << tableBits) >> 40) * 0x1.0p-24f;
+        if constexpr (Correction == NcoCorrection::Linear)
+        {
+            return table[index] + fraction * (table[index + 1] - table[index]);
+        }
+        else
+        {
+            // sin(a + d) ~ sin(a) + d * cos(a) - d^2 / 2 * sin(a), cos(a) is the entry a quarter cycle ahead
+            const uint64_t mask = (uint64_t(1) << tableBits) - 1;
+            const float s = table[index];
+            const float c = table[(index + (uint64_t(1) << (tableBits - 2))) & mask];
+            const float d = fraction * static_cast<float>(2 * Constants::PI) / static_cast<float>(uint64_t(1) << tableBits);
+            return s + d * (c - 0.5f * d * s);
+        }
+    }
+
+    template <NcoCorrection Correction>
+    void GenerateBlock(const float *table, int tableBits, uint64_t phase, uint64_t increment, float amplitude, float offset, float *out, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            out[i] = amplitude * LookupSine<Correction>(table, tableBits, phase) + offset;
+            phase += increment;
+        }
+    }
+
+    // A (sin(phase) - j cos(phase)), the cosine is the sine a quarter cycle ahead
+    template <NcoCorrection Correction>
+    void GenerateEnvelope(const float *table, int tableBits, uint64_t phase, uint64_t increment, float amplitude, Complex *out, int count)
+    {
+        constexpr uint64_t QuarterCycle = uint64_t(1) << 62;
+        for (int i = 0; i < count; i++)
+        {
+            out[i] = Complex(amplitude * LookupSine<Correction>(table, tableBits, phase),
+                             -amplitude * LookupSine<Correction>(table, tableBits, phase + QuarterCycle));
+            phase += increment;
+        }
+    }
+}
+
+float NcoSignalGenerator::Lookup(uint64_t phase) const
+{
+    switch (m_Settings.correction)
+    {
+    case NcoCorrection::None:
+        return LookupSine<NcoCorrection::None>(m_Table->data(), m_Settings.tableBits, phase);
+    case NcoCorrection::Linear:
+        return LookupSine<NcoCorrection::Linear>(m_Table->data(), m_Settings.tableBits, phase);
+    case NcoCorrection::Taylor:
+        return LookupSine<NcoCorrection::Taylor>(m_Table->data(), m_Settings.tableBits, phase);
+    }
+    return 0.0f;
+}
+
+uint64_t NcoSignalGenerator::PhaseOffset() const
+{
+    // The phase parameter as a fraction of a cycle in fixed point
+    return Clock::PhaseIncrement(m_Parameters.phase / (2 * Constants::PI), 1.0);
+}
+
+double NcoSignalGenerator::Sample(double time) const
+{
+    const uint64_t phase = (Clock::PhaseIncrement(m_Parameters.frequency, time) + PhaseOffset()) & PhaseMask();
+    return m_Parameters.amplitude * Lookup(phase) + m_Parameters.offset;
+}
+
+Complex NcoSignalGenerator::SampleEnvelope(double time) const
+{
+    const double offsetFrequency = m_Parameters.frequency - m_Parameters.carrierFrequency;
+    const uint64_t phase = (Clock::PhaseIncrement(offsetFrequency, time) + PhaseOffset()) & PhaseMask();
+    const float amplitude = static_cast<float>(m_Parameters.amplitude);
+    return {amplitude * Lookup(phase), -amplitude * Lookup(phase + (uint64_t(1) << 62))};
+}
+
+void NcoSignalGenerator::AccumulatorPhase(const SimulationBlock &block, double frequency, uint64_t &phase, uint64_t &increment) const
+{
+    // The accumulator starts at the phase of sample 0 on the tick clock, every later sample is a whole number
+    // of increments away. Both are truncated to the accumulator width like the registers of a hardware NCO.
+    const uint64_t mask = PhaseMask();
+    const int64_t firstTick = block.startTick - static_cast<int64_t>(block.sampleIndex) * block.ticksPerSample;
+    const uint64_t phaseZero = (Clock::PhaseAtTick(frequency, block.tickPeriod, firstTick) + PhaseOffset()) & mask;
+    increment = Clock::PhaseIncrement(frequency, block.dt) & mask;
+    phase = phaseZero + block.sampleIndex * increment;
+}
+
+void NcoSignalGenerator::ProcessBlock(const SimulationBlock &block)
+{
+    const float amplitude = static_cast<float>(m_Parameters.amplitude);
+    const float *table = m_Table->data();
+    const int tableBits = m_Settings.tableBits;
+    uint64_t phase;
+    uint64_t increment;
+
+    if (m_Output.isConnected())
+    {
+        const float offset = static_cast<float>(m_Parameters.offset);
+        float *out = m_Output.Data();
+        AccumulatorPhase(block, m_Parameters.frequency, phase, increment);
+
+        switch (m_Settings.correction)
+        {
+        case NcoCorrection::None:
+            GenerateBlock<NcoCorrection::None>(table, tableBits, phase, increment, amplitude, offset, out, block.nSamples);
+            break;
+        case NcoCorrection::Linear:
+            GenerateBlock<NcoCorrection::Linear>(table, tableBits, phase, increment, amplitude, offset, out, block.nSamples);
+            break;
+        case NcoCorrection::Taylor:
+            GenerateBlock<NcoCorrection::Taylor>(table, tableBits, phase, increment, amplitude, offset, out, block.nSamples);
+            break;
+        }
+
+        GatePulses(block, out);
+    }
+
+    // In baseband the accumulator runs at the offset from the carrier, like a digital down-converter's NCO
+    if (m_ComplexOutput.isConnected())
+    {
+        Complex *out = m_ComplexOutput.Data();
+        AccumulatorPhase(block, m_Parameters.frequency - m_Parameters.carrierFrequency, phase, increment);
+
+        switch (m_Settings.correction)
+        {
+        case NcoCorrection::None:
+            GenerateEnvelope<NcoCorrection::None>(table, tableBits, phase, increment, amplitude, out, block.nSamples);
+            break;
+        case NcoCorrection::Linear:
+            GenerateEnvelope<NcoCorrection::Linear>(table, tableBits, phase, increment, amplitude, out, block.nSamples);
+            break;
+        case NcoCorrection::Taylor:
+            GenerateEnvelope<NcoCorrection::Taylor>(table, tableBits, phase, increment, amplitude, out, block.nSamples);
+            break;
+        }
+
+        GatePulses(block, out);
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "SignalGenerator.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+enum class NcoCorrection
+{
+    None,   // Nearest table entry, max error about PI / tableSize
+    Linear, // Linear interpolation between entries, max error about (2 * PI / tableSize)^2 / 8
+    Taylor, // Second order Taylor expansion around the entry, max error about (2 * PI / tableSize)^3 / 6
+};
+
+struct NcoSettings
+{
+    int phaseBits = 32;  // Width of the phase accumulator, 32 or 64
+    int tableBits = 10;  // log2 of the number of sine table entries over one cycle
+    NcoCorrection correction = NcoCorrection::Linear;
+};
+
+// Numerically controlled oscillator, amplitude * sin(phase) + offset where the phase is a fixed point
+// accumulator advanced by a constant increment every sample and the sine comes from a lookup table, as in
+// an FPGA NCO. The phase of sample n is exactly phase0 + n * increment modulo the accumulator width, so it
+// is continuous across blocks whatever their size. The table is shared by every NCO with the same size.
+class NcoSignalGenerator : public SignalGenerator
+{
+public:
+    NcoSignalGenerator(const SignalParameters &parameters, const NcoSettings &settings = NcoSettings());
+
+    double Sample(double time) const override;
+    Complex SampleEnvelope(double time) const override;
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    const NcoSettings &getSettings() const { return m_Settings; }
+
+private:
+    // Sine of a fixed point phase through the table
+    float Lookup(uint64_t phase) const;
+    uint64_t PhaseOffset() const;
+
+    // Accumulator value at the first sample of the block and its increment for a frequency
+    void AccumulatorPhase(const SimulationBlock &block, double frequency, uint64_t &phase, uint64_t &increment) const;
+
+    uint64_t PhaseMask() const { return m_Settings.phaseBits >= 64 ? ~uint64_t(0) : ~uint64_t(0) << (64 - m_Settings.phaseBits); }
+
+    NcoSettings m_Settings;
+    std::shared_ptr<const std::vector<float>> m_Table; // tableSize + 1 entries, the last one repeats the first
+};
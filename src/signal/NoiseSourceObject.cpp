@@ -0,0 +1,39 @@
+#include "NoiseSourceObject.hpp"
+
+#include "core/Random.hpp"
+
+#include <cmath>
+
+double NoiseSourceObject::StandardDeviation(double dt) const
+{
+    // P = N0 / dt watts in the sampled band, a complex envelope of power P into R has E|v|^2 = 2 P R
+    const double density = std::pow(10.0, (m_Settings.noiseDensity - 30.0) / 10.0);
+    return std::sqrt(density / dt * m_Settings.impedance);
+}
+
+void NoiseSourceObject::ProcessBlock(const SimulationBlock &block)
+{
+    const int channels = m_Output.getChannels();
+    const int count = block.nSamples * channels;
+    Complex *out = m_Output.Data();
+
+    // Complex<float> is two floats, so the pairs of Gaussian values fill I and Q directly
+    const RandomStream stream(block.seed, getObjectId());
+    stream.Gaussian(2 * block.sampleIndex * channels, reinterpret_cast<float *>(out), 2 * count);
+
+    const float sigma = static_cast<float>(StandardDeviation(block.dt));
+    if (const Complex *in = m_Input.Data())
+    {
+        for (int i = 0; i < count; i++)
+        {
+            out[i] = in[i] + sigma * out[i];
+        }
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            out[i] *= sigma;
+        }
+    }
+}
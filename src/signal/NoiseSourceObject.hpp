@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/Port.hpp"
+#include "core/SimulationObject.hpp"
+
+#include <vector>
+
+struct NoiseSettings
+{
+    double noiseDensity = -174.0; // dBm/Hz, thermal noise at 290 K
+    double impedance = 50.0;      // Ohm, converts the noise power into a voltage
+    int channels = 4;             // One per receive horn
+};
+
+// Additive white Gaussian noise on every channel of a complex baseband signal. The "out" port carries the "in"
+// port plus noise, or the noise alone if nothing is connected to "in". The noise covers the whole sampled band,
+// its power is noiseDensity * sampleRate, split evenly between I and Q.
+//
+// Sample i of channel c uses Gaussian values 2 (i * channels + c) and 2 (i * channels + c) + 1 of the
+// RandomStream keyed by the simulation seed and the object id, so every channel gets its own independent
+// values and the noise doesn't depend on the block size or the thread count.
+class NoiseSourceObject : public SimulationObject
+{
+public:
+    NoiseSourceObject(const NoiseSettings &settings = NoiseSettings())
+        : m_Settings(settings), m_Input(this, "in", settings.channels), m_Output(this, "out", settings.channels) {}
+
+    void Initialize() override {}
+    void Finalize() override {}
+    void Reset() override {}
+
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    const NoiseSettings &getSettings() const { return m_Settings; }
+
+    // The channel count is fixed by the ports
+    void setNoiseDensity(double noiseDensity) { m_Settings.noiseDensity = noiseDensity; }
+    void setImpedance(double impedance) { m_Settings.impedance = impedance; }
+
+    // Standard deviation of I and Q for a sample period dt
+    double StandardDeviation(double dt) const;
+
+    InputPort<Complex> &getInput() { return m_Input; }
+    OutputPort<Complex> &getOutput() { return m_Output; }
+
+private:
+    NoiseSettings m_Settings;
+    InputPort<Complex> m_Input;
+    OutputPort<Complex> m_Output;
+};
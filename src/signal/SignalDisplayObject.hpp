@@ -1,83 +1,179 @@
 #pragma once
 
+#include "core/Port.hpp"
 #include "core/SimulationObject.hpp"
+#include "core/StateArchive.hpp"
+#include "core/TripleBuffer.hpp"
 
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Ring buffer contents unrolled from oldest to newest value
+struct SignalSnapshot
+{
+    std::vector<float> signal;     // Real signal, or the in-phase part of a complex one
+    std::vector<float> quadrature; // Quadrature part, empty for a real signal
+};
+
+// Records the signal on its "in" port, or the complex signal on its "iq" port, into a ring buffer so it can be
+// displayed (see gui/SignalPlot)
 class SignalDisplayObject : public SimulationObject
 {
 public:
-    SignalDisplayObject(int size) : size(size), m_SignalBuffer(size, 0)
+    SignalDisplayObject(int size) : m_SignalBuffer(size, 0), size(size)
     {
     }
 
     void Initialize() override
     {
         m_SignalBuffer.resize(size, 0);
+        m_QuadratureBuffer.resize(m_ComplexInput.isConnected() ? size : 0, 0);
     }
 
-    void Update(double dt) override
+    void ProcessBlock(const SimulationBlock &block) override
     {
-        time += static_cast<float>(dt);
-        addValue(generateSineWave(time));
+        if (const Complex *in = m_ComplexInput.Data())
+        {
+            m_QuadratureBuffer.resize(m_SignalBuffer.size(), 0);
+            Record(in, block.nSamples);
+        }
+        else if (const float *in = m_Input.Data())
+        {
+            Record(in, block.nSamples);
+        }
     }
 
-    void Render() override
+    // Only records what its producers deliver, it never keeps the simulation busy on its own
+    ActivityWindow NextActivity(int64_t tick, double tickPeriod) const override
     {
-        if (ImGui::Begin("Signal Display"))
-        {
-            if (ImPlot::BeginPlot("Signal Plot"))
-            {
-                ImPlot::SetupAxis(ImAxis_X1, "Count");
-                // ImPlot::SetupAxisFormat(ImAxis_X1, "%d Count");
-
-                ImPlot::SetupAxis(ImAxis_Y1, "Amplitude");
-                ImPlot::SetupAxisFormat(ImAxis_Y1, "%0.1f V");
-
-                ImPlot::PlotLine("Signal", m_SignalBuffer.data(), (int)m_SignalBuffer.size());
-            }
-            ImPlot::EndPlot();
-        }
-        ImGui::End();
+        return {ActivityWindow::Never, ActivityWindow::Never};
     }
 
-    void
-    Finalize() override
+    void Finalize() override
     {
         m_SignalBuffer.resize(size, 0);
     }
 
     void Reset() override
     {
-        m_SignalBuffer.resize(size, 0);
+        m_SignalBuffer.assign(size, 0);
+        std::fill(m_QuadratureBuffer.begin(), m_QuadratureBuffer.end(), 0.0f);
         index = 0;
     }
 
-    float generateSineWave(float time)
+    void Publish() override
+    {
+        SignalSnapshot &snapshot = m_Snapshot.Back();
+        Unroll(m_SignalBuffer, snapshot.signal);
+        Unroll(m_QuadratureBuffer, snapshot.quadrature);
+        m_Snapshot.Publish();
+    }
+
+    void SaveState(StateWriter &writer) const override
     {
-        float amplitude = 10;
-        float frequency = 1000;
-        return amplitude * static_cast<float>(sin(frequency * time));
-    };
+        writer.WriteVector(m_SignalBuffer);
+        writer.WriteVector(m_QuadratureBuffer);
+        writer.Write(index);
+    }
 
-    void addValue(float value)
+    void LoadState(StateReader &reader) override
     {
-        // if index is greater than the size of the signal, reset the index
-        if (index >= m_SignalBuffer.size())
+        reader.ReadVector(m_SignalBuffer);
+        reader.ReadVector(m_QuadratureBuffer);
+        reader.Read(index);
+        if (!m_QuadratureBuffer.empty() && m_QuadratureBuffer.size() != m_SignalBuffer.size())
         {
-            index = 0;
+            throw std::runtime_error("SignalDisplayObject state has a quadrature buffer that doesn't match its signal buffer");
         }
-
-        m_SignalBuffer[index] = value;
-        index++;
+        size = static_cast<int>(m_SignalBuffer.size());
+        index = std::clamp(index, 0, size);
     }
 
+    // Real signal or in-phase part
     const std::vector<float> &getSignal() const
     {
         return m_SignalBuffer;
     }
 
+    // Quadrature part, empty unless a complex signal is recorded
+    const std::vector<float> &getQuadrature() const
+    {
+        return m_QuadratureBuffer;
+    }
+
+    // Latest published signal, only call from the UI thread
+    const SignalSnapshot &getSnapshot()
+    {
+        m_Snapshot.Fetch();
+        return m_Snapshot.Front();
+    }
+
+    InputPort<float> &getInput() { return m_Input; }
+    InputPort<Complex> &getComplexInput() { return m_ComplexInput; }
+
 private:
+    static float RealPart(float value) { return value; }
+    static float RealPart(Complex value) { return value.real(); }
+
+    template <typename T>
+    void Record(const T *in, int nSamples)
+    {
+        const int bufferSize = static_cast<int>(m_SignalBuffer.size());
+        if (bufferSize == 0)
+        {
+            return;
+        }
+
+        // Samples that would be overwritten within this block are never copied
+        const int skipped = std::max(nSamples - bufferSize, 0);
+        in += skipped;
+
+        int remaining = nSamples - skipped;
+        while (remaining > 0)
+        {
+            if (index >= bufferSize)
+            {
+                index = 0;
+            }
+
+            const int count = std::min(remaining, bufferSize - index);
+            for (int i = 0; i < count; i++)
+            {
+                m_SignalBuffer[index + i] = RealPart(in[i]);
+            }
+            if constexpr (std::is_same_v<T, Complex>)
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    m_QuadratureBuffer[index + i] = in[i].imag();
+                }
+            }
+
+            in += count;
+            index += count;
+            remaining -= count;
+        }
+    }
+
+    void Unroll(const std::vector<float> &buffer, std::vector<float> &snapshot) const
+    {
+        snapshot.resize(buffer.size());
+        if (buffer.empty())
+        {
+            return;
+        }
+        std::copy(buffer.begin() + index, buffer.end(), snapshot.begin());
+        std::copy(buffer.begin(), buffer.begin() + index, snapshot.end() - index);
+    }
+
+    InputPort<float> m_Input{this, "in"};
+    InputPort<Complex> m_ComplexInput{this, "iq"};
     std::vector<float> m_SignalBuffer;
-    float time = 0;
+    std::vector<float> m_QuadratureBuffer;
+    TripleBuffer<SignalSnapshot> m_Snapshot;
     int size = 0;
     int index = 0;
-};
\ No newline at end of file
+};
@@ -1,10 +1,131 @@
 #include "SignalGenerator.hpp"
 
-#include <core/Constants.hpp>
+#include "core/Clock.hpp"
+#include "core/Constants.hpp"
+#include "core/StateArchive.hpp"
 
+#include <algorithm>
 #include <cmath>
 
-double SignalGenerator::Update(double time)
+namespace
 {
-    return m_Parameters.amplitude * sin(2 * Constants::PI * m_Parameters.frequency * time + m_Parameters.phase) + m_Parameters.offset;
+    // Pulse repetition interval and pulse width in ticks, the interval is 0 for continuous signals
+    void PulseTicks(const SignalParameters &parameters, double tickPeriod, int64_t &interval, int64_t &width)
+    {
+        interval = 0;
+        width = 0;
+        if (parameters.pulseRepetitionInterval > 0.0)
+        {
+            interval = std::max<int64_t>(Clock::TimeToTicks(parameters.pulseRepetitionInterval, tickPeriod), 1);
+            width = std::clamp<int64_t>(Clock::TimeToTicks(parameters.pulseWidth, tickPeriod), 0, interval);
+        }
+    }
+
+    // Ticks since the start of the pulse repetition interval containing tick
+    int64_t PulseOffset(int64_t tick, int64_t interval)
+    {
+        const int64_t offset = tick % interval;
+        return offset < 0 ? offset + interval : offset;
+    }
+
+    template <typename T>
+    void GateSamples(const SignalParameters &parameters, const SimulationBlock &block, T *out)
+    {
+        int64_t interval;
+        int64_t width;
+        PulseTicks(parameters, block.tickPeriod, interval, width);
+        if (interval == 0 || width == interval)
+        {
+            return;
+        }
+
+        // Walk the position within the interval instead of taking a modulo per sample
+        const int64_t step = block.ticksPerSample % interval;
+        int64_t offset = PulseOffset(block.startTick, interval);
+        for (int i = 0; i < block.nSamples; i++)
+        {
+            if (offset >= width)
+            {
+                out[i] = T{};
+            }
+            offset += step;
+            if (offset >= interval)
+            {
+                offset -= interval;
+            }
+        }
+    }
+}
+
+Complex SignalGenerator::SampleEnvelope(double time) const
+{
+    const double value = Sample(time) - m_Parameters.offset;
+    const double phase = -2 * Constants::PI * m_Parameters.carrierFrequency * time;
+    return {static_cast<float>(value * std::cos(phase)), static_cast<float>(value * std::sin(phase))};
+}
+
+void SignalGenerator::ProcessBlock(const SimulationBlock &block)
+{
+    if (m_Output.isConnected())
+    {
+        float *out = m_Output.Data();
+        for (int i = 0; i < block.nSamples; i++)
+        {
+            out[i] = static_cast<float>(Sample(block.SampleTime(i)));
+        }
+        GatePulses(block, out);
+    }
+
+    if (m_ComplexOutput.isConnected())
+    {
+        Complex *out = m_ComplexOutput.Data();
+        for (int i = 0; i < block.nSamples; i++)
+        {
+            out[i] = SampleEnvelope(block.SampleTime(i));
+        }
+        GatePulses(block, out);
+    }
+}
+
+ActivityWindow SignalGenerator::NextActivity(int64_t tick, double tickPeriod) const
+{
+    int64_t interval;
+    int64_t width;
+    PulseTicks(m_Parameters, tickPeriod, interval, width);
+    if (interval == 0 || width == interval)
+    {
+        return {tick, ActivityWindow::Never};
+    }
+    if (width == 0)
+    {
+        return {ActivityWindow::Never, ActivityWindow::Never};
+    }
+
+    // Inside a pulse the window lasts until its end, otherwise it is the next pulse
+    const int64_t pulseStart = tick - PulseOffset(tick, interval);
+    if (tick < pulseStart + width)
+    {
+        return {tick, pulseStart + width};
+    }
+    return {pulseStart + interval, pulseStart + interval + width};
+}
+
+void SignalGenerator::GatePulses(const SimulationBlock &block, float *out) const
+{
+    GateSamples(m_Parameters, block, out);
+}
+
+void SignalGenerator::GatePulses(const SimulationBlock &block, Complex *out) const
+{
+    GateSamples(m_Parameters, block, out);
+}
+
+void SignalGenerator::SaveState(StateWriter &writer) const
+{
+    writer.Write(m_Parameters);
+}
+
+void SignalGenerator::LoadState(StateReader &reader)
+{
+    SetParameters(reader.Read<SignalParameters>());
 }
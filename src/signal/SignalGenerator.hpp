@@ -2,14 +2,51 @@
 
 #include "SignalParameters.hpp"
 
-class SignalGenerator
+#include "core/Port.hpp"
+#include "core/SimulationObject.hpp"
+
+// Base class for signal sources. Writes one real sample per time step to its "out" port and the complex envelope
+// around carrierFrequency to its "iq" port, only the outputs that are connected are computed.
+class SignalGenerator : public SimulationObject
 {
 public:
     SignalGenerator(const SignalParameters &parameters) : m_Parameters(parameters) {}
     virtual ~SignalGenerator() = default;
 
-    virtual double Update(double time) = 0;
+    // Value of the signal at the given time
+    virtual double Sample(double time) const = 0;
+
+    // Complex envelope of the signal around carrierFrequency at the given time, Re{envelope * e^(j 2 PI fc t)} is
+    // the signal without its offset. The default only mixes Sample() down without filtering, so it keeps the image
+    // at -2 fc, generators that know their analytic signal override it.
+    virtual Complex SampleEnvelope(double time) const;
+
+    void Initialize() override {}
+    void Finalize() override {}
+    void Reset() override {}
+
+    // Evaluates Sample() and SampleEnvelope() for every time step of the block, subclasses override this with a
+    // faster block generator
+    void ProcessBlock(const SimulationBlock &block) override;
+
+    // Pulsed generators are only active while a pulse is transmitted
+    ActivityWindow NextActivity(int64_t tick, double tickPeriod) const override;
+
+    void SaveState(StateWriter &writer) const override;
+    void LoadState(StateReader &reader) override;
+
+    const SignalParameters &getParameters() const { return m_Parameters; }
+    virtual void SetParameters(const SignalParameters &parameters) { m_Parameters = parameters; }
+
+    OutputPort<float> &getOutput() { return m_Output; }
+    OutputPort<Complex> &getComplexOutput() { return m_ComplexOutput; }
+
+protected:
+    // Zeroes the samples of the block that fall between pulses, does nothing for continuous signals
+    void GatePulses(const SimulationBlock &block, float *out) const;
+    void GatePulses(const SimulationBlock &block, Complex *out) const;
 
-private:
     SignalParameters m_Parameters;
+    OutputPort<float> m_Output{this, "out"};
+    OutputPort<Complex> m_ComplexOutput{this, "iq"};
 };
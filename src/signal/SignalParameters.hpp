@@ -1,9 +1,57 @@
 #pragma once
 
+#include <string>
+
 struct SignalParameters
 {
-    double amplitude;
-    double frequency;
-    double phase;
-    double offset;
-};
\ No newline at end of file
+    double amplitude = 1.0; // V
+    double frequency = 0.0; // Hz
+    double phase = 0.0;     // rad
+    double offset = 0.0;    // V
+
+    // Complex baseband, the "iq" output carries the envelope of the signal around this frequency so it can be
+    // sampled at the signal's bandwidth instead of the carrier's rate. offset only applies to the real output.
+    double carrierFrequency = 0.0; // Hz
+
+    // Pulsed transmission, the signal is on for pulseWidth at the start of every pulseRepetitionInterval
+    double pulseRepetitionInterval = 0.0; // sec, 0 transmits continuously
+    double pulseWidth = 0.0;              // sec
+};
+
+// Sets the SignalParameters field called name (e.g. "amplitude"), returns false if there is no such field
+inline bool SetSignalParameter(SignalParameters &parameters, const std::string &name, double value)
+{
+    if (name == "amplitude")
+    {
+        parameters.amplitude = value;
+    }
+    else if (name == "frequency")
+    {
+        parameters.frequency = value;
+    }
+    else if (name == "phase")
+    {
+        parameters.phase = value;
+    }
+    else if (name == "offset")
+    {
+        parameters.offset = value;
+    }
+    else if (name == "carrierFrequency")
+    {
+        parameters.carrierFrequency = value;
+    }
+    else if (name == "pulseRepetitionInterval")
+    {
+        parameters.pulseRepetitionInterval = value;
+    }
+    else if (name == "pulseWidth")
+    {
+        parameters.pulseWidth = value;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
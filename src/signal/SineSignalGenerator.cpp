@@ -0,0 +1,64 @@
+#include "SineSignalGenerator.hpp"
+
+#include <core/Clock.hpp>
+#include <core/Constants.hpp>
+#include <dsp/SinCos.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+double SineSignalGenerator::Sample(double time) const
+{
+    return m_Parameters.amplitude * sin(2 * Constants::PI * m_Parameters.frequency * time + m_Parameters.phase) + m_Parameters.offset;
+}
+
+Complex SineSignalGenerator::SampleEnvelope(double time) const
+{
+    // A sin(theta) = Re{A (sin(theta) - j cos(theta)) e^(j 2 PI fc t)} with theta relative to the carrier
+    const double theta = 2 * Constants::PI * (m_Parameters.frequency - m_Parameters.carrierFrequency) * time + m_Parameters.phase;
+    return {static_cast<float>(m_Parameters.amplitude * std::sin(theta)), static_cast<float>(-m_Parameters.amplitude * std::cos(theta))};
+}
+
+void SineSignalGenerator::ProcessBlock(const SimulationBlock &block)
+{
+    const float amplitude = static_cast<float>(m_Parameters.amplitude);
+    const uint64_t phaseOffset = Clock::PhaseIncrement(m_Parameters.phase / (2 * Constants::PI), 1.0);
+
+    // Phase is computed exactly from the tick clock, so it stays accurate over arbitrarily long runs
+    if (m_Output.isConnected())
+    {
+        const float offset = static_cast<float>(m_Parameters.offset);
+        float *out = m_Output.Data();
+
+        const uint64_t startPhase = Clock::PhaseAtTick(m_Parameters.frequency, block.tickPeriod, block.startTick) + phaseOffset;
+        const uint64_t phasePerSample = Clock::PhaseIncrement(m_Parameters.frequency, block.dt);
+
+        Dsp::Sin(startPhase, phasePerSample, out, block.nSamples);
+        for (int i = 0; i < block.nSamples; i++)
+        {
+            out[i] = amplitude * out[i] + offset;
+        }
+
+        GatePulses(block, out);
+    }
+
+    // The envelope rotates at the offset from the carrier only, which is what makes baseband cheap
+    if (m_ComplexOutput.isConnected())
+    {
+        const double offsetFrequency = m_Parameters.frequency - m_Parameters.carrierFrequency;
+        Complex *out = m_ComplexOutput.Data();
+
+        const uint64_t startPhase = Clock::PhaseAtTick(offsetFrequency, block.tickPeriod, block.startTick) + phaseOffset;
+        const uint64_t phasePerSample = Clock::PhaseIncrement(offsetFrequency, block.dt);
+
+        m_Sin.resize(std::max<size_t>(m_Sin.size(), block.nSamples));
+        m_Cos.resize(std::max<size_t>(m_Cos.size(), block.nSamples));
+        Dsp::SinCos(startPhase, phasePerSample, m_Sin.data(), m_Cos.data(), block.nSamples);
+        for (int i = 0; i < block.nSamples; i++)
+        {
+            out[i] = Complex(amplitude * m_Sin[i], -amplitude * m_Cos[i]);
+        }
+
+        GatePulses(block, out);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "SignalGenerator.hpp"
+
+#include <vector>
+
+// amplitude * sin(2 * PI * frequency * t + phase) + offset
+class SineSignalGenerator : public SignalGenerator
+{
+public:
+    SineSignalGenerator(const SignalParameters &parameters) : SignalGenerator(parameters) {}
+
+    double Sample(double time) const override;
+    Complex SampleEnvelope(double time) const override;
+    void ProcessBlock(const SimulationBlock &block) override;
+
+private:
+    // Scratch for the envelope's quadrature kernels, grown to the largest block
+    std::vector<float> m_Sin;
+    std::vector<float> m_Cos;
+};